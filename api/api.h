@@ -49,6 +49,13 @@
    and is defined even if <complex.h> is not included) */
 #define FFTW_NO_Complex
 
+/* in double-double precision the API uses our own arithmetic type */
+#include "config.h"
+#ifdef FFTW_DDOUBLE
+#  include "dd.h"
+#  define FFTW_DD_REAL dd
+#endif
+
 #include "fftw3.h"
 #include "ifftw.h"
 #include "rdft.h"
@@ -63,6 +70,12 @@ struct X(plan_s) {
      plan *pln;
      problem *prb;
      int sign;
+
+     /* plan-memory manager, see plan-memory.c */
+     enum wakefulness wakefulness; /* when awake */
+     int asleep;
+     size_t bytes;               /* tables made by the last awakening */
+     struct X(plan_s) *prev, *next; /* awake plans, most recent first */
 };
 
 /* shorthand */
@@ -85,6 +98,9 @@ const int *X(rdft2_pad)(int rnk, const int *n, const int *nembed,
 			int inplace, int cmplx, int **nfree);
 
 int X(many_kosherp)(int rnk, const int *n, int howmany);
+int X(axes_kosherp)(int rank, const int *n, int naxes, const int *axes);
+tensor *X(mktensor_axes)(int rank, const int *n, int naxes, const int *axes,
+			 int vecp, INT s);
 int X(guru_kosherp)(int rank, const X(iodim) *dims,
 		    int howmany_rank, const X(iodim) *howmany_dims);
 int X(guru64_kosherp)(int rank, const X(iodim64) *dims,
@@ -101,6 +117,56 @@ void X(mapflags)(planner *, unsigned);
 
 apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb);
 
+INT X(howmany_max)(const problem *prb);
+problem *X(howmany_subproblem)(const problem *prb, INT n);
+plan *X(mkplan_howmany)(const problem *prb, plan *cld, plan **sub, int nsub);
+
+typedef plan *(*mkplan_fn)(planner *plnr, unsigned flags,
+			   const problem *prb, int hash_info);
+
+/* makes a plan for PRB out of several plans, each planned with MK */
+typedef plan *(*mkcomposite_fn)(planner *plnr, unsigned flags,
+				const problem *prb, int hash_info,
+				mkplan_fn mk, const void *arg);
+apiplan *X(mkapiplan_composite)(int sign, unsigned flags, problem *prb,
+				mkcomposite_fn mkc, const void *arg);
+plan *X(mkplan_rdft2_packed)(planner *plnr, unsigned flags,
+			     const problem *prb, int hash_info, mkplan_fn mk,
+			     const void *arg);
+problem *X(mkproblem_rdft2_packed)(int rank, const int *n,
+				   const int *nembed, int stride, int dist,
+				   int howmany, R *r, int sign,
+				   unsigned flags);
+
+/* a polyphase filter bank, see pfb.c */
+typedef struct {
+     INT m, taps, vl;		/* channels, taps, spectra per execution */
+     INT is, os, ovs;		/* input and output strides, and the
+				   distance between output spectra */
+     const R *h;		/* TAPS x M coefficients */
+} pfb;
+
+plan *X(mkplan_pfb)(planner *plnr, unsigned flags, const problem *prb,
+		    int hash_info, mkplan_fn mk, const void *arg);
+
+/* set by the threads library: calls WORK(DATA, i) for 0 <= i < NTHR,
+   each in its own thread */
+extern void (*X(spawn_hook))(int nthr, void (*work)(void *data, int i),
+			     void *data);
+
+/* set by the MPI library: runs a split-phase execution of P that is
+   still in flight to completion before P is destroyed */
+IFFTW_EXTERN void (*X(destroy_plan_hook))(X(plan) p);
+
+extern size_t X(plan_memory_cap);
+void X(apiplan_register)(apiplan *p);
+void X(apiplan_unregister)(apiplan *p);
+void X(apiplan_touch)(apiplan *p);
+/* a plan may still be asleep after the cap has been lifted */
+#define APIPLAN_TOUCH(p) do {					\
+     if (X(plan_memory_cap) || (p)->asleep) X(apiplan_touch)(p);	\
+} while (0)
+
 rdft_kind *X(map_r2r_kind)(int rank, const X(r2r_kind) * kind);
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@ static plan *mkplan0(planner *plnr, unsigned flags,
 {
      /* map API flags into FFTW flags */
      X(mapflags)(plnr, flags);
+     plnr->layout_wisdom = (flags & FFTW_WISDOM_LAYOUT) != 0;
 
      plnr->flags.hash_info = hash_info;
      plnr->wisdom_state = wisdom_state;
@@ -75,10 +76,64 @@ static plan *mkplan(planner *plnr, unsigned flags,
      return pln;
 }
 
-apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
+static plan *mkplan_wisdom_only(planner *plnr, unsigned flags,
+				const problem *prb, int hash_info)
+{
+     return mkplan0(plnr, flags, prb, hash_info, WISDOM_ONLY);
+}
+
+/* plan PRB with MK, except that composite plans (MKC) are made of
+   several plans, each planned with MK */
+static plan *mkplan_api(planner *plnr, unsigned flags,
+			const problem *prb, int hash_info, mkplan_fn mk,
+			mkcomposite_fn mkc, const void *arg)
+{
+     if (mkc)
+	  return mkc(plnr, flags, prb, hash_info, mk, arg);
+     return mk(plnr, flags, prb, hash_info);
+}
+
+/* FFTW_VARIABLE_HOWMANY: wrap CLD, the plan for PRB, together with
+   plans for 2^j of its vectors made by MK, see howmany.c */
+static plan *mkplan_howmany(planner *plnr, unsigned flags,
+			    const problem *prb, plan *cld, int hash_info,
+			    mkplan_fn mk, mkcomposite_fn mkc, const void *arg)
+{
+     INT nmax = X(howmany_max)(prb);
+     plan **sub;
+     int j, nsub;
+
+     if (nmax < 0) {
+	  X(plan_destroy_internal)(cld);
+	  return 0;
+     }
+
+     for (nsub = 0; ((INT) 1 << nsub) < nmax; ++nsub)
+	  ;
+     sub = nsub ? (plan **) MALLOC(sizeof(plan *) * nsub, PLANS) : 0;
+
+     for (j = 0; j < nsub; ++j) {
+	  problem *sp = X(howmany_subproblem)(prb, (INT) 1 << j);
+	  sub[j] = mkplan_api(plnr, flags, sp, hash_info, mk, mkc, arg);
+	  X(problem_destroy)(sp);
+	  if (!sub[j]) {
+	       while (--j >= 0)
+		    X(plan_destroy_internal)(sub[j]);
+	       X(ifree0)(sub);
+	       X(plan_destroy_internal)(cld);
+	       return 0;
+	  }
+     }
+
+     return X(mkplan_howmany)(prb, cld, sub, nsub);
+}
+
+apiplan *X(mkapiplan_composite)(int sign, unsigned flags, problem *prb,
+				mkcomposite_fn mkc, const void *arg)
 {
      apiplan *p = 0;
      plan *pln;
+     arena *a = 0;
      unsigned flags_used_for_planning;
      planner *plnr = X(the_planner)();
      unsigned int pats[] = {FFTW_ESTIMATE, FFTW_MEASURE,
@@ -91,7 +146,10 @@ apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
 	     and returns 0 otherwise.  This is now documented in the manual,
 	     as a way to detect whether wisdom is available for a problem. */
 	  flags_used_for_planning = flags;
-	  pln = mkplan0(plnr, flags, prb, 0, WISDOM_ONLY);
+	  pln = mkplan_api(plnr, flags, prb, 0, mkplan_wisdom_only, mkc, arg);
+	  if (pln && (flags & FFTW_VARIABLE_HOWMANY))
+	       pln = mkplan_howmany(plnr, flags, prb, pln, 0,
+				    mkplan_wisdom_only, mkc, arg);
      } else {
 	  pat_max = flags & FFTW_ESTIMATE ? 0 :
 	       (flags & FFTW_EXHAUSTIVE ? 3 :
@@ -108,7 +166,10 @@ apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
 	  for (pln = 0, flags_used_for_planning = 0; pat <= pat_max; ++pat) {
 	       plan *pln1;
 	       unsigned tmpflags = flags | pats[pat];
-	       pln1 = mkplan(plnr, tmpflags, prb, 0);
+	       pln1 = mkplan_api(plnr, tmpflags, prb, 0, mkplan, mkc, arg);
+	       if (pln1 && (flags & FFTW_VARIABLE_HOWMANY))
+		    pln1 = mkplan_howmany(plnr, tmpflags, prb, pln1, 0,
+					  mkplan, mkc, arg);
 
 	       if (!pln1) {
 		    /* don't bother continuing if planner failed or timed out */
@@ -129,20 +190,42 @@ apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
 	  p->prb = prb;
 	  p->sign = sign; /* cache for execute_dft */
 	  
-	  /* re-create plan from wisdom, adding blessing */
-	  p->pln = mkplan(plnr, flags_used_for_planning, prb, BLESSING);
+	  /* re-create plan from wisdom, adding blessing, and pack it
+	     and its tables into an arena if requested.  The plans for
+	     FFTW_VARIABLE_HOWMANY were searched for above, so they too
+	     come from wisdom and no search runs inside the arena. */
+	  a = X(arena_begin)();
+	  p->pln = mkplan_api(plnr, flags_used_for_planning, prb, BLESSING,
+			      mkplan, mkc, arg);
+	  if (p->pln && (flags & FFTW_VARIABLE_HOWMANY))
+	       p->pln = mkplan_howmany(plnr, flags_used_for_planning,
+				       prb, p->pln, BLESSING, mkplan, mkc, arg);
+     }
+
+     if (p && !p->pln) {
+	  /* FFTW_VARIABLE_HOWMANY on a problem without a single vector
+	     loop, or a sub-problem that could not be planned */
+	  X(arena_end)(a);
+	  X(ifree)(p);
+	  X(plan_destroy_internal)(pln);
+	  pln = 0;
+	  p = 0;
+     }
 
+     if (pln) {
 	  /* record pcost from most recent measurement for use in X(cost) */
 	  p->pln->pcost = pcost;
 
 	  if (sizeof(trigreal) > sizeof(R)) {
 	       /* this is probably faster, and we have enough trigreal
 		  bits to maintain accuracy */
-	       X(plan_awake)(p->pln, AWAKE_SQRTN_TABLE);
+	       p->wakefulness = AWAKE_SQRTN_TABLE;
 	  } else {
 	       /* more accurate */
-	       X(plan_awake)(p->pln, AWAKE_SINCOS);
+	       p->wakefulness = AWAKE_SINCOS;
 	  }
+	  X(apiplan_register)(p); /* awakens it */
+	  X(arena_end)(a);
 	  
 	  /* we don't use pln for p->pln, above, since by re-creating the
 	     plan we might use more patient wisdom from a timed-out mkplan */
@@ -160,10 +243,19 @@ apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
      return p;
 }
 
+apiplan *X(mkapiplan)(int sign, unsigned flags, problem *prb)
+{
+     return X(mkapiplan_composite)(sign, flags, prb, 0, 0);
+}
+
+void (*X(destroy_plan_hook))(X(plan) p) = 0;
+
 void X(destroy_plan)(X(plan) p)
 {
      if (p) {
-          X(plan_awake)(p->pln, SLEEPY);
+          if (X(destroy_plan_hook))
+               X(destroy_plan_hook)(p);
+          X(apiplan_unregister)(p); /* puts it to sleep */
           X(plan_destroy_internal)(p->pln);
           X(problem_destroy)(p->prb);
           X(ifree)(p);
@@ -25,6 +25,7 @@
 void X(execute_dft)(const X(plan) p, C *in, C *out)
 {
      plan_dft *pln = (plan_dft *) p->pln;
+     APIPLAN_TOUCH(p);
      if (p->sign == FFT_SIGN)
 	  pln->apply((plan *) pln, in[0], in[0]+1, out[0], out[0]+1);
      else
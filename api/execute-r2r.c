@@ -25,5 +25,6 @@
 void X(execute_r2r)(const X(plan) p, R *in, R *out)
 {
      plan_rdft *pln = (plan_rdft *) p->pln;
+     APIPLAN_TOUCH(p);
      pln->apply((plan *) pln, in, out);
 }
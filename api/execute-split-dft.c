@@ -25,5 +25,6 @@
 void X(execute_split_dft)(const X(plan) p, R *ri, R *ii, R *ro, R *io)
 {
      plan_dft *pln = (plan_dft *) p->pln;
+     APIPLAN_TOUCH(p);
      pln->apply((plan *) pln, ri, ii, ro, io);
 }
@@ -23,5 +23,6 @@
 void X(execute)(const X(plan) p)
 {
      plan *pln = p->pln;
+     APIPLAN_TOUCH(p);
      pln->adt->solve(pln, p->prb);
 }
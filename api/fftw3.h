@@ -67,6 +67,7 @@ extern "C"
 #define FFTW_MANGLE_FLOAT(name) FFTW_CONCAT(fftwf_, name)
 #define FFTW_MANGLE_LONG_DOUBLE(name) FFTW_CONCAT(fftwl_, name)
 #define FFTW_MANGLE_QUAD(name) FFTW_CONCAT(fftwq_, name)
+#define FFTW_MANGLE_DD(name) FFTW_CONCAT(fftwdd_, name)
 
 /* IMPORTANT: for Windows compilers, you should add a line
         #define FFTW_DLL
@@ -92,6 +93,11 @@ enum fftw_r2r_kind_do_not_use_me {
      FFTW_RODFT00=7, FFTW_RODFT01=8, FFTW_RODFT10=9, FFTW_RODFT11=10
 };
 
+/* options for fftw_plan_with_arena, which are not planner flags */
+enum fftw_arena_option_do_not_use_me {
+     FFTW_ARENA_ON=1, FFTW_ARENA_LOCK=2, FFTW_ARENA_HUGEPAGE=4
+};
+
 struct fftw_iodim_do_not_use_me {
      int n;                     /* dimension size */
      int is;			/* input stride */
@@ -105,6 +111,38 @@ struct fftw_iodim64_do_not_use_me {
      ptrdiff_t os;			/* output stride */
 };
 
+/* planner statistics, see fftw_planner_solver_stats */
+struct fftw_solver_stats_do_not_use_me {
+     const char *name;          /* registration name of the solver */
+     int id;                    /* registration number, as in wisdom */
+     int invocations;           /* times the planner tried the solver */
+     int plans;                 /* times the solver returned a plan */
+     int measurements;          /* plans of the solver that were timed */
+     int wins;                  /* times its plan was the best */
+     double measure_time;       /* seconds spent timing its plans */
+};
+
+struct fftw_problem_stats_do_not_use_me {
+     const char *kind;          /* "dft", "rdft", "rdft2", "mpi-dft", ... */
+     int problems;              /* problems planned, including subproblems */
+     int hits, misses;          /* wisdom lookups */
+     int searches;              /* problems not answered by wisdom */
+     int relaxed;               /* searches that succeeded only after
+				   relaxing the impatience flags */
+     int timeouts;              /* searches abandoned at the time limit */
+};
+
+/* plan-memory manager statistics, see fftw_set_plan_memory_cap */
+struct fftw_memory_stats_do_not_use_me {
+     size_t cap;                /* bytes, 0 if there is no cap */
+     size_t resident;           /* bytes of tables of the awake plans */
+     int plans;                 /* live plans */
+     int asleep;                /* plans currently asleep */
+     int sleeps;                /* times a plan was put to sleep */
+     int awakenings;            /* times a plan was awakened to execute */
+     double awaken_time;        /* seconds spent awakening plans */
+};
+
 typedef void (*fftw_write_char_func_do_not_use_me)(char c, void *);
 typedef int (*fftw_read_char_func_do_not_use_me)(void *);
 
@@ -115,11 +153,16 @@ typedef int (*fftw_read_char_func_do_not_use_me)(void *);
   X: name-mangling macro
   R: real data type
   C: complex data type
+
+  FFTW_DEFINE_API_BODY assumes that C has already been defined.
 */
 
 #define FFTW_DEFINE_API(X, R, C)					   \
 									   \
 FFTW_DEFINE_COMPLEX(R, C);						   \
+FFTW_DEFINE_API_BODY(X, R, C)
+
+#define FFTW_DEFINE_API_BODY(X, R, C)					   \
 									   \
 typedef struct X(plan_s) *X(plan);					   \
 									   \
@@ -128,6 +171,10 @@ typedef struct fftw_iodim64_do_not_use_me X(iodim64);			   \
 									   \
 typedef enum fftw_r2r_kind_do_not_use_me X(r2r_kind);			   \
 									   \
+typedef struct fftw_solver_stats_do_not_use_me X(solver_stats);		   \
+typedef struct fftw_problem_stats_do_not_use_me X(problem_stats);	   \
+typedef struct fftw_memory_stats_do_not_use_me X(memory_stats);		   \
+									   \
 typedef fftw_write_char_func_do_not_use_me X(write_char_func);		   \
 typedef fftw_read_char_func_do_not_use_me X(read_char_func);		   \
 									   \
@@ -151,6 +198,10 @@ FFTW_EXTERN X(plan) X(plan_many_dft)(int rank, const int *n,		   \
                          int ostride, int odist,			   \
                          int sign, unsigned flags);			   \
 									   \
+FFTW_EXTERN X(plan) X(plan_dft_axes)(int rank, const int *n,		   \
+                         int naxes, const int *axes,			   \
+                         C *in, C *out, int sign, unsigned flags);	   \
+									   \
 FFTW_EXTERN X(plan) X(plan_guru_dft)(int rank, const X(iodim) *dims,	   \
 			 int howmany_rank,				   \
 			 const X(iodim) *howmany_dims,			   \
@@ -274,6 +325,13 @@ FFTW_EXTERN void X(execute_split_dft_r2c)(const X(plan) p,		   \
 FFTW_EXTERN void X(execute_split_dft_c2r)(const X(plan) p,		   \
                                           R *ri, R *ii, R *out);	   \
 									   \
+FFTW_EXTERN X(plan) X(plan_pfb_dft)(int channels, int taps,		   \
+                         const R *coeffs, int howmany,			   \
+                         C *in, C *out, int sign, unsigned flags);	   \
+FFTW_EXTERN X(plan) X(plan_pfb_r2c)(int channels, int taps,		   \
+                         const R *coeffs, int howmany,			   \
+                         R *in, C *out, unsigned flags);		   \
+									   \
 FFTW_EXTERN X(plan) X(plan_many_r2r)(int rank, const int *n,		   \
                          int howmany,					   \
                          R *in, const int *inembed,			   \
@@ -282,6 +340,11 @@ FFTW_EXTERN X(plan) X(plan_many_r2r)(int rank, const int *n,		   \
                          int ostride, int odist,			   \
                          const X(r2r_kind) *kind, unsigned flags);	   \
 									   \
+FFTW_EXTERN X(plan) X(plan_r2r_axes)(int rank, const int *n,		   \
+                         int naxes, const int *axes,			   \
+                         R *in, R *out,					   \
+                         const X(r2r_kind) *kind, unsigned flags);	   \
+									   \
 FFTW_EXTERN X(plan) X(plan_r2r)(int rank, const int *n, R *in, R *out,	   \
                     const X(r2r_kind) *kind, unsigned flags);		   \
 									   \
@@ -309,15 +372,27 @@ FFTW_EXTERN X(plan) X(plan_guru64_r2r)(int rank, const X(iodim64) *dims,   \
 									   \
 FFTW_EXTERN void X(execute_r2r)(const X(plan) p, R *in, R *out);	   \
 									   \
+FFTW_EXTERN int X(plan_set_howmany)(X(plan) p, int howmany);		   \
+									   \
 FFTW_EXTERN void X(destroy_plan)(X(plan) p);				   \
 FFTW_EXTERN void X(forget_wisdom)(void);				   \
 FFTW_EXTERN void X(cleanup)(void);					   \
 									   \
 FFTW_EXTERN void X(set_timelimit)(double t);				   \
+FFTW_EXTERN int X(set_shared_tables)(const char *directory);		   \
+FFTW_EXTERN int X(plan_with_arena)(unsigned flags);			   \
+FFTW_EXTERN void X(set_plan_memory_cap)(size_t bytes);			   \
+FFTW_EXTERN void X(plan_memory_stats)(X(memory_stats) *stats);		   \
+FFTW_EXTERN void X(fprint_plan_memory_stats)(FILE *output_file);	   \
 									   \
 FFTW_EXTERN void X(plan_with_nthreads)(int nthreads);			   \
 FFTW_EXTERN int X(init_threads)(void);					   \
 FFTW_EXTERN void X(cleanup_threads)(void);				   \
+FFTW_EXTERN void X(plan_with_thread_telemetry)(int enable);		   \
+FFTW_EXTERN void X(threads_set_callback)(				   \
+     void (*parallel_loop)(void *(*work)(char *), char *jobdata,	   \
+                           size_t elsize, int njobs, void *data),	   \
+     void *data);							   \
 									   \
 FFTW_EXTERN int X(export_wisdom_to_filename)(const char *filename);	   \
 FFTW_EXTERN void X(export_wisdom_to_file)(FILE *output_file);		   \
@@ -333,6 +408,11 @@ FFTW_EXTERN int X(import_wisdom)(X(read_char_func) read_char, void *data); \
 FFTW_EXTERN void X(fprint_plan)(const X(plan) p, FILE *output_file);	   \
 FFTW_EXTERN void X(print_plan)(const X(plan) p);			   \
 									   \
+FFTW_EXTERN int X(planner_solver_stats)(X(solver_stats) *stats, int n);	   \
+FFTW_EXTERN int X(planner_problem_stats)(X(problem_stats) *stats, int n);  \
+FFTW_EXTERN void X(reset_planner_stats)(void);				   \
+FFTW_EXTERN void X(fprint_planner_stats)(FILE *output_file);		   \
+									   \
 FFTW_EXTERN void *X(malloc)(size_t n);					   \
 FFTW_EXTERN R *X(alloc_real)(size_t n);					   \
 FFTW_EXTERN C *X(alloc_complex)(size_t n);				   \
@@ -371,6 +451,22 @@ FFTW_DEFINE_API(FFTW_MANGLE_LONG_DOUBLE, long double, fftwl_complex)
 FFTW_DEFINE_API(FFTW_MANGLE_QUAD, __float128, fftwq_complex)
 #endif
 
+/* double-double precision (compiled in FFTW with --enable-double-double):
+   a real number is the unevaluated sum hi + lo of two doubles.  Its API
+   is only declared on request, by #defining FFTW_DD before including
+   this file.  C++ code with its own double-double class of the same
+   layout may instead #define FFTW_DD_REAL to that class.  The complex
+   type is always an array, whatever FFTW_DEFINE_COMPLEX says. */
+#if defined(FFTW_DD) || (defined(__cplusplus) && defined(FFTW_DD_REAL))
+#  ifdef FFTW_DD_REAL
+typedef FFTW_DD_REAL fftwdd_real;
+#  else
+typedef struct { double hi, lo; } fftwdd_real;
+#  endif
+typedef fftwdd_real fftwdd_complex[2];
+FFTW_DEFINE_API_BODY(FFTW_MANGLE_DD, fftwdd_real, fftwdd_complex)
+#endif
+
 #define FFTW_FORWARD (-1)
 #define FFTW_BACKWARD (+1)
 
@@ -386,6 +482,9 @@ FFTW_DEFINE_API(FFTW_MANGLE_QUAD, __float128, fftwq_complex)
 #define FFTW_PATIENT (1U << 5) /* IMPATIENT is default */
 #define FFTW_ESTIMATE (1U << 6)
 #define FFTW_WISDOM_ONLY (1U << 21)
+#define FFTW_WISDOM_LAYOUT (1U << 22)
+#define FFTW_VARIABLE_HOWMANY (1U << 23)
+#define FFTW_PACKED (1U << 24)
 
 /* undocumented beyond-guru flags */
 #define FFTW_ESTIMATE_PATIENT (1U << 7)
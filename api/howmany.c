@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Plans with a variable number of vectors (FFTW_VARIABLE_HOWMANY).
+
+   Besides the plan CLD for all the NMAX vectors of the problem, we
+   make at planning time one plan SUB[j] for 2^j vectors, for each
+   2^j < NMAX.  Executing with N < NMAX vectors applies the SUB[j]
+   for the bits j of N, one after the other, each to the vectors
+   that follow the ones already done.  Thus there is no planning at
+   execution time, at most lg NMAX child plans run per execution,
+   and each of them (and its threading) was planned for a vector
+   count within a factor of two of the one it is applied to.
+
+   The sub-problems are tainted as unaligned if the vector strides
+   do not preserve the alignment, since the SUB[j] are applied at
+   offsets other than zero. */
+
+#include "api.h"
+#include "dft.h"
+#include "rdft.h"
+
+typedef struct {
+     union {
+	  plan_dft dft;
+	  plan_rdft rdft;
+	  plan_rdft2 rdft2;
+     } super;
+
+     plan *cld;
+     plan **sub;
+     int nsub;
+     INT n, nmax;
+     INT is, os;
+} P;
+
+static void apply_dft(const plan *ego_, R *ri, R *ii, R *ro, R *io)
+{
+     const P *ego = (const P *) ego_;
+     INT n = ego->n, is = ego->is, os = ego->os;
+     plan_dft *cld;
+     int j;
+
+     if (n == ego->nmax) {
+	  cld = (plan_dft *) ego->cld;
+	  cld->apply((plan *) cld, ri, ii, ro, io);
+	  return;
+     }
+
+     for (j = ego->nsub - 1; j >= 0; --j) {
+	  INT m = (INT) 1 << j;
+	  if (n & m) {
+	       cld = (plan_dft *) ego->sub[j];
+	       cld->apply((plan *) cld, ri, ii, ro, io);
+	       ri += m * is; ii += m * is;
+	       ro += m * os; io += m * os;
+	  }
+     }
+}
+
+static void apply_rdft(const plan *ego_, R *I, R *O)
+{
+     const P *ego = (const P *) ego_;
+     INT n = ego->n, is = ego->is, os = ego->os;
+     plan_rdft *cld;
+     int j;
+
+     if (n == ego->nmax) {
+	  cld = (plan_rdft *) ego->cld;
+	  cld->apply((plan *) cld, I, O);
+	  return;
+     }
+
+     for (j = ego->nsub - 1; j >= 0; --j) {
+	  INT m = (INT) 1 << j;
+	  if (n & m) {
+	       cld = (plan_rdft *) ego->sub[j];
+	       cld->apply((plan *) cld, I, O);
+	       I += m * is;
+	       O += m * os;
+	  }
+     }
+}
+
+/* for rdft2, IS and OS are the strides of the real and of the
+   complex arrays, see X(rdft2_strides) */
+static void apply_rdft2(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     INT n = ego->n, rs = ego->is, cs = ego->os;
+     plan_rdft2 *cld;
+     int j;
+
+     if (n == ego->nmax) {
+	  cld = (plan_rdft2 *) ego->cld;
+	  cld->apply((plan *) cld, r0, r1, cr, ci);
+	  return;
+     }
+
+     for (j = ego->nsub - 1; j >= 0; --j) {
+	  INT m = (INT) 1 << j;
+	  if (n & m) {
+	       cld = (plan_rdft2 *) ego->sub[j];
+	       cld->apply((plan *) cld, r0, r1, cr, ci);
+	       r0 += m * rs; r1 += m * rs;
+	       cr += m * cs; ci += m * cs;
+	  }
+     }
+}
+
+static void awake(plan *ego_, enum wakefulness wakefulness)
+{
+     P *ego = (P *) ego_;
+     int j;
+
+     X(plan_awake)(ego->cld, wakefulness);
+     for (j = 0; j < ego->nsub; ++j)
+	  X(plan_awake)(ego->sub[j], wakefulness);
+}
+
+static void destroy(plan *ego_)
+{
+     P *ego = (P *) ego_;
+     int j;
+
+     for (j = 0; j < ego->nsub; ++j)
+	  X(plan_destroy_internal)(ego->sub[j]);
+     X(ifree0)(ego->sub);
+     X(plan_destroy_internal)(ego->cld);
+}
+
+static void print(const plan *ego_, printer *p)
+{
+     const P *ego = (const P *) ego_;
+     int j;
+
+     p->print(p, "(howmany-%D/%D%(%p%)", ego->n, ego->nmax, ego->cld);
+     for (j = 0; j < ego->nsub; ++j)
+	  p->print(p, "%(%p%)", ego->sub[j]);
+     p->putchr(p, ')');
+}
+
+static const tensor *vecsz_of(const problem *prb)
+{
+     switch (prb->adt->problem_kind) {
+	 case PROBLEM_DFT:
+	      return ((const problem_dft *) prb)->vecsz;
+	 case PROBLEM_RDFT:
+	      return ((const problem_rdft *) prb)->vecsz;
+	 case PROBLEM_RDFT2:
+	      return ((const problem_rdft2 *) prb)->vecsz;
+	 default:
+	      return 0;
+     }
+}
+
+/* the vector dimension that varies, or 0 if there is none */
+static const iodim *vecdim(const problem *prb)
+{
+     const tensor *vecsz = vecsz_of(prb);
+     return (vecsz && vecsz->rnk == 1) ? vecsz->dims : 0;
+}
+
+/* Number of vectors of PRB, or -1 if PRB does not have a single
+   vector dimension to vary.  A problem without a vector loop counts
+   as one vector. */
+INT X(howmany_max)(const problem *prb)
+{
+     const tensor *vecsz = vecsz_of(prb);
+
+     if (!vecsz || !FINITE_RNK(vecsz->rnk) || vecsz->rnk > 1)
+	  return -1;
+     return vecsz->rnk == 1 ? vecsz->dims[0].n : 1;
+}
+
+/* PRB restricted to its first N vectors */
+problem *X(howmany_subproblem)(const problem *prb, INT n)
+{
+     const iodim *d = vecdim(prb);
+     tensor *vecsz;
+
+     A(d && n <= d->n);
+     switch (prb->adt->problem_kind) {
+	 case PROBLEM_DFT: {
+	      const problem_dft *p = (const problem_dft *) prb;
+	      vecsz = X(tensor_copy)(p->vecsz);
+	      vecsz->dims[0].n = n;
+	      return X(mkproblem_dft_d)(X(tensor_copy)(p->sz), vecsz,
+					TAINT(p->ri, d->is),
+					TAINT(p->ii, d->is),
+					TAINT(p->ro, d->os),
+					TAINT(p->io, d->os));
+	 }
+	 case PROBLEM_RDFT: {
+	      const problem_rdft *p = (const problem_rdft *) prb;
+	      vecsz = X(tensor_copy)(p->vecsz);
+	      vecsz->dims[0].n = n;
+	      return X(mkproblem_rdft_d)(X(tensor_copy)(p->sz), vecsz,
+					 TAINT(p->I, d->is),
+					 TAINT(p->O, d->os), p->kind);
+	 }
+	 case PROBLEM_RDFT2: {
+	      const problem_rdft2 *p = (const problem_rdft2 *) prb;
+	      INT rs, cs;
+	      X(rdft2_strides)(p->kind, d, &rs, &cs);
+	      vecsz = X(tensor_copy)(p->vecsz);
+	      vecsz->dims[0].n = n;
+	      return X(mkproblem_rdft2_d)(X(tensor_copy)(p->sz), vecsz,
+					  TAINT(p->r0, rs), TAINT(p->r1, rs),
+					  TAINT(p->cr, cs), TAINT(p->ci, cs),
+					  p->kind);
+	 }
+	 default:
+	      A(0);
+	      return 0;
+     }
+}
+
+static const plan_adt padt_dft = {
+     X(dft_solve), awake, print, destroy
+};
+
+static const plan_adt padt_rdft = {
+     X(rdft_solve), awake, print, destroy
+};
+
+static const plan_adt padt_rdft2 = {
+     X(rdft2_solve), awake, print, destroy
+};
+
+/* Wrap CLD, the plan for all the vectors of PRB, and the plans SUB
+   for 2^j of them, 0 <= j < NSUB.  Consumes CLD and SUB. */
+plan *X(mkplan_howmany)(const problem *prb, plan *cld, plan **sub, int nsub)
+{
+     const iodim *d = vecdim(prb);
+     P *pln;
+
+     switch (prb->adt->problem_kind) {
+	 case PROBLEM_DFT:
+	      pln = MKPLAN_DFT(P, &padt_dft, apply_dft);
+	      break;
+	 case PROBLEM_RDFT:
+	      pln = MKPLAN_RDFT(P, &padt_rdft, apply_rdft);
+	      break;
+	 case PROBLEM_RDFT2:
+	      pln = MKPLAN_RDFT2(P, &padt_rdft2, apply_rdft2);
+	      break;
+	 default:
+	      A(0);
+	      return 0;
+     }
+
+     pln->cld = cld;
+     pln->sub = sub;
+     pln->nsub = nsub;
+     pln->nmax = pln->n = X(howmany_max)(prb);
+     pln->is = pln->os = 0;
+     if (d) {
+	  if (prb->adt->problem_kind == PROBLEM_RDFT2)
+	       X(rdft2_strides)(((const problem_rdft2 *) prb)->kind, d,
+				&pln->is, &pln->os);
+	  else {
+	       pln->is = d->is;
+	       pln->os = d->os;
+	  }
+     }
+
+     X(ops_cpy)(&cld->ops, &pln->super.dft.super.ops);
+     pln->super.dft.super.pcost = cld->pcost;
+     return &(pln->super.dft.super);
+}
+
+int X(plan_set_howmany)(X(plan) p, int howmany)
+{
+     const plan_adt *adt = p->pln->adt;
+     P *pln = (P *) p->pln;
+
+     if (adt != &padt_dft && adt != &padt_rdft && adt != &padt_rdft2)
+	  return 0; /* not planned with FFTW_VARIABLE_HOWMANY */
+     if (howmany < 0 || howmany > pln->nmax)
+	  return 0;
+     pln->n = howmany;
+     return 1;
+}
@@ -24,6 +24,8 @@
 #  define WISDOM_NAME "wisdomf"
 #elif defined(FFTW_LDOUBLE)
 #  define WISDOM_NAME "wisdoml"
+#elif defined(FFTW_DDOUBLE)
+#  define WISDOM_NAME "wisdomdd"
 #else
 #  define WISDOM_NAME "wisdom"
 #endif
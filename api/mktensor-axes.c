@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Tensors for transforms of a row-major array of size
+   N[0] x ... x N[RANK-1] along some of its axes.  As in numpy, a
+   negative axis counts from the end, so that -1 is the last one. */
+
+#include "api.h"
+
+static int axis(int rank, int a)
+{
+     return a < 0 ? a + rank : a;
+}
+
+int X(axes_kosherp)(int rank, const int *n, int naxes, const int *axes)
+{
+     int i, j;
+
+     if (!X(many_kosherp)(rank, n, 1)) return 0;
+     if (naxes < 0 || naxes > rank) return 0;
+
+     for (i = 0; i < naxes; ++i) {
+	  int a = axis(rank, axes[i]);
+	  if (a < 0 || a >= rank) return 0;
+	  for (j = 0; j < i; ++j)
+	       if (axis(rank, axes[j]) == a) return 0; /* repeated */
+     }
+     return 1;
+}
+
+/* the dimensions AXES[0..NAXES-1] if VECP is 0, and the other ones
+   (in order) otherwise, with stride S for the last dimension */
+tensor *X(mktensor_axes)(int rank, const int *n, int naxes, const int *axes,
+			 int vecp, INT s)
+{
+     INT *stride = (INT *) MALLOC(sizeof(INT) * rank, TENSORS);
+     char *transformed = (char *) MALLOC(sizeof(char) * rank, TENSORS);
+     tensor *x;
+     int i, k;
+
+     for (i = rank - 1; i >= 0; --i) {
+	  stride[i] = s;
+	  s *= n[i];
+	  transformed[i] = 0;
+     }
+     for (i = 0; i < naxes; ++i)
+	  transformed[axis(rank, axes[i])] = 1;
+
+     x = X(mktensor)(vecp ? rank - naxes : naxes);
+     for (i = k = 0; k < x->rnk; ++i) {
+	  int a = vecp ? i : axis(rank, axes[i]);
+	  if (vecp && transformed[a])
+	       continue;
+	  x->dims[k].n = n[a];
+	  x->dims[k].is = x->dims[k].os = stride[a];
+	  ++k;
+     }
+
+     X(ifree)(transformed);
+     X(ifree)(stride);
+     return x;
+}
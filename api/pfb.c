@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/* Polyphase filter banks (channelizers).
+
+   A filter bank of M channels and T taps with coefficients H[T M]
+   turns a stream of samples x[j] into one spectrum per M samples.
+   Spectrum s is the DFT of size M of
+
+      y[k] = sum_{t = 0}^{T - 1} H[t M + k] x[(s + t - (T - 1)) M + k],
+
+   that is, of the last T M samples windowed by H and folded into M.
+   Each execution consumes VL M new samples and produces VL spectra;
+   the plan keeps the last (T - 1) M samples of the stream (initially
+   zero) for the next execution.
+
+   Instead of computing all the y's and then transforming them, the
+   plan computes the y's of a block of spectra into a buffer that
+   fits in the cache, and transforms the block with a child plan
+   right away, so that the stream is read once and the y's never go
+   to memory.  With threads, each thread works on its own range of
+   blocks, with its own buffer.
+
+   The problem is an ordinary DFT or RDFT2 problem, whose pointers are
+   the stream and the spectra.  It is never given to the planner: only
+   its children are. */
+
+#include "api.h"
+#include "dft.h"
+#include "rdft.h"
+
+void (*X(spawn_hook))(int nthr, void (*work)(void *data, int i),
+		      void *data) = 0;
+
+typedef struct {
+     union {
+	  plan_dft dft;
+	  plan_rdft2 rdft2;
+     } super;
+
+     plan *cld, *cldrest;
+     R *h, *hist;
+     INT m, taps, vl, is, ovs;
+     INT nb, bufdist, bufsz;	/* spectra per block, and the buffer */
+     INT ys, roffset, ioffset;	/* layout of the buffer */
+     int cplx, nthr;
+     INT nblk_by_thr;
+} P;
+
+typedef struct {
+     const P *ego;
+     const R *ri, *ii;
+     R *ro, *io;
+} PD;
+
+/* Y[k * YS] for spectrum S of the stream X, whose earlier samples are
+   in HIST */
+static void fir(const P *ego, const R *hist, const R *x, INT s,
+		R *y, INT ys)
+{
+     INT m = ego->m, nh = (ego->taps - 1) * m, t, k;
+     const R *h = ego->h;
+
+     for (t = 0; t < ego->taps; ++t, h += m) {
+	  INT j = (s + t) * m - nh;
+	  const R *xt;
+	  INT xs;
+
+	  if (j < 0) {
+	       xt = hist + (j + nh);
+	       xs = 1;
+	  } else {
+	       xt = x + j * ego->is;
+	       xs = ego->is;
+	  }
+
+	  if (t == 0)
+	       for (k = 0; k < m; ++k)
+		    y[k * ys] = h[k] * xt[k * xs];
+	  else
+	       for (k = 0; k < m; ++k)
+		    y[k * ys] += h[k] * xt[k * xs];
+     }
+}
+
+/* spectra S0 ... S0 + N - 1, with CLD */
+static void block(const PD *d, const plan *cld, INT s0, INT n, R *buf)
+{
+     const P *ego = d->ego;
+     INT b, nh = (ego->taps - 1) * ego->m, bd = ego->bufdist * ego->ys;
+     INT od = s0 * ego->ovs;
+     R *br = buf + ego->roffset, *bi = buf + ego->ioffset;
+
+     for (b = 0; b < n; ++b) {
+	  fir(ego, ego->hist, d->ri, s0 + b, br + b * bd, ego->ys);
+	  if (ego->cplx)
+	       fir(ego, ego->hist + nh, d->ii, s0 + b, bi + b * bd, ego->ys);
+     }
+
+     if (ego->cplx) {
+	  const plan_dft *c = (const plan_dft *) cld;
+	  c->apply(cld, br, bi, d->ro + od, d->io + od);
+     } else {
+	  const plan_rdft2 *c = (const plan_rdft2 *) cld;
+	  c->apply(cld, buf, buf + 1, d->ro + od, d->io + od);
+     }
+}
+
+static void blocks(void *d_, int i)
+{
+     const PD *d = (const PD *) d_;
+     const P *ego = d->ego;
+     INT b = i * ego->nblk_by_thr;
+     INT bmax = X(imin)(b + ego->nblk_by_thr, ego->vl / ego->nb);
+     R *buf = (R *) MALLOC(sizeof(R) * ego->bufsz, BUFFERS);
+
+     for (; b < bmax; ++b)
+	  block(d, ego->cld, b * ego->nb, ego->nb, buf);
+     X(ifree)(buf);
+}
+
+/* the history for the next execution: the last (T - 1) M samples of
+   HIST followed by X */
+static void remember(const P *ego, const R *x, R *hist)
+{
+     INT nh = (ego->taps - 1) * ego->m, nx = ego->vl * ego->m, j;
+
+     if (nx < nh) {
+	  for (j = 0; j < nh - nx; ++j)
+	       hist[j] = hist[j + nx];
+	  for (; j < nh; ++j)
+	       hist[j] = x[(j - (nh - nx)) * ego->is];
+     } else {
+	  for (j = 0; j < nh; ++j)
+	       hist[j] = x[(nx - nh + j) * ego->is];
+     }
+}
+
+static void apply(const P *ego, const R *ri, const R *ii, R *ro, R *io)
+{
+     INT rest = ego->vl % ego->nb;
+     PD d;
+     R *buf;
+     int i;
+
+     d.ego = ego;
+     d.ri = ri; d.ii = ii;
+     d.ro = ro; d.io = io;
+
+     if (ego->nthr > 1 && X(spawn_hook))
+	  X(spawn_hook)(ego->nthr, blocks, &d);
+     else
+	  for (i = 0; i < ego->nthr; ++i)
+	       blocks(&d, i);
+
+     if (rest) {
+	  buf = (R *) MALLOC(sizeof(R) * ego->bufsz, BUFFERS);
+	  block(&d, ego->cldrest, ego->vl - rest, rest, buf);
+	  X(ifree)(buf);
+     }
+
+     /* only now, since all the spectra read the old history */
+     remember(ego, ri, ego->hist);
+     if (ego->cplx)
+	  remember(ego, ii, ego->hist + (ego->taps - 1) * ego->m);
+}
+
+static void apply_dft(const plan *ego_, R *ri, R *ii, R *ro, R *io)
+{
+     apply((const P *) ego_, ri, ii, ro, io);
+}
+
+static void apply_rdft2(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     UNUSED(r1);
+     apply((const P *) ego_, r0, 0, cr, ci);
+}
+
+static void awake(plan *ego_, enum wakefulness wakefulness)
+{
+     P *ego = (P *) ego_;
+
+     X(plan_awake)(ego->cld, wakefulness);
+     X(plan_awake)(ego->cldrest, wakefulness);
+}
+
+static void destroy(plan *ego_)
+{
+     P *ego = (P *) ego_;
+
+     X(plan_destroy_internal)(ego->cldrest);
+     X(plan_destroy_internal)(ego->cld);
+     X(ifree)(ego->hist);
+     X(ifree)(ego->h);
+}
+
+static void print(const plan *ego_, printer *p)
+{
+     const P *ego = (const P *) ego_;
+
+     p->print(p, "(pfb-%D/%D-x%D/%D-%d%(%p%)%(%p%))",
+	      ego->m, ego->taps, ego->nb, ego->vl, ego->nthr,
+	      ego->cld, ego->cldrest);
+}
+
+/* the transform of N spectra from BUF to the outputs of P_ */
+static problem *mkcld(const problem *p_, const pfb *a, INT n, INT bufdist,
+		      R *buf, INT roffset, INT ioffset, INT od, INT taint)
+{
+     if (p_->adt->problem_kind == PROBLEM_DFT) {
+	  const problem_dft *p = (const problem_dft *) p_;
+	  return X(mkproblem_dft_d)(
+	       X(mktensor_1d)(a->m, 2, a->os),
+	       X(mktensor_1d)(n, 2 * bufdist, a->ovs),
+	       buf + roffset, buf + ioffset,
+	       TAINT(p->ro + od, taint), TAINT(p->io + od, taint));
+     } else {
+	  const problem_rdft2 *p = (const problem_rdft2 *) p_;
+	  return X(mkproblem_rdft2_d_3pointers)(
+	       X(mktensor_1d)(a->m, 1, a->os),
+	       X(mktensor_1d)(n, bufdist, a->ovs),
+	       buf, TAINT(p->cr + od, taint), TAINT(p->ci + od, taint),
+	       R2HC);
+     }
+}
+
+static plan *mkchild(planner *plnr, unsigned flags, problem *prb,
+		     int hash_info, mkplan_fn mk)
+{
+     plan *pln = mk(plnr, flags, prb, hash_info);
+     X(problem_destroy)(prb);
+     return pln;
+}
+
+plan *X(mkplan_pfb)(planner *plnr, unsigned flags, const problem *p_,
+		    int hash_info, mkplan_fn mk, const void *arg)
+{
+     const pfb *a = (const pfb *) arg;
+     int cplx = p_->adt->problem_kind == PROBLEM_DFT;
+     plan *cld = 0, *cldrest = 0;
+     INT m = a->m, vl = a->vl, nb, nblk, bufdist, bufsz, roffset, ioffset;
+     INT nh = (a->taps - 1) * m, nblk_by_thr, rest, j;
+     int nthr, plnr_nthr = plnr->nthr;
+     R *buf;
+     P *pln;
+
+     static const plan_adt padt_dft = {
+	  X(dft_solve), awake, print, destroy
+     };
+     static const plan_adt padt_rdft2 = {
+	  X(rdft2_solve), awake, print, destroy
+     };
+
+     /* enough blocks for all the threads, if possible */
+     nthr = X(spawn_hook) ? plnr->nthr : 1;
+     nb = X(nbuf)(m, (vl + nthr - 1) / nthr, 0);
+     nblk = vl / nb;
+     nblk_by_thr = (nblk + nthr - 1) / nthr;
+     nthr = (int) ((nblk + nblk_by_thr - 1) / nblk_by_thr);
+     rest = vl - nb * nblk;
+
+     bufdist = X(bufdist)(m, nb);
+     if (cplx) {
+	  const problem_dft *p = (const problem_dft *) p_;
+	  /* keep the real and imaginary parts in the same order, as in
+	     dft/buffered.c */
+	  roffset = (p->ri - p->ii > 0) ? (INT)1 : (INT)0;
+	  ioffset = 1 - roffset;
+	  bufsz = 2 * nb * bufdist;
+     } else {
+	  roffset = ioffset = 0;
+	  bufsz = nb * bufdist;
+     }
+
+     /* initial allocation for the purpose of planning */
+     buf = (R *) MALLOC(sizeof(R) * bufsz, BUFFERS);
+
+     /* each thread transforms its blocks with cld */
+     plnr->nthr = (plnr->nthr + nthr - 1) / nthr;
+     cld = mkchild(plnr, flags,
+		   mkcld(p_, a, nb, bufdist, buf, roffset, ioffset,
+			 0, a->ovs * nb),
+		   hash_info, mk);
+     plnr->nthr = plnr_nthr;
+     if (!cld) goto nada;
+
+     cldrest = mkchild(plnr, flags,
+		       mkcld(p_, a, rest, bufdist, buf, roffset, ioffset,
+			     a->ovs * (vl - rest), 0),
+		       hash_info, mk);
+     if (!cldrest) goto nada;
+
+     /* deallocate the buffer, let apply() allocate it for real */
+     X(ifree)(buf);
+
+     if (cplx)
+	  pln = MKPLAN_DFT(P, &padt_dft, apply_dft);
+     else
+	  pln = MKPLAN_RDFT2(P, &padt_rdft2, apply_rdft2);
+     pln->cld = cld;
+     pln->cldrest = cldrest;
+     pln->h = (R *) MALLOC(sizeof(R) * a->taps * m, PLANS);
+     for (j = 0; j < a->taps * m; ++j)
+	  pln->h[j] = a->h[j];
+     pln->hist = (R *) MALLOC(sizeof(R) * (cplx ? 2 : 1) * nh, PLANS);
+     for (j = 0; j < (cplx ? 2 : 1) * nh; ++j)
+	  pln->hist[j] = K(0.0);
+     pln->m = m;
+     pln->taps = a->taps;
+     pln->vl = vl;
+     pln->is = a->is;
+     pln->ovs = a->ovs;
+     pln->nb = nb;
+     pln->bufdist = bufdist;
+     pln->bufsz = bufsz;
+     pln->ys = cplx ? 2 : 1;
+     pln->roffset = roffset;
+     pln->ioffset = ioffset;
+     pln->cplx = cplx;
+     pln->nthr = nthr;
+     pln->nblk_by_thr = nblk_by_thr;
+
+     {
+	  opcnt *ops = &pln->super.dft.super.ops;
+	  X(ops_madd)(nblk, &cld->ops, &cldrest->ops, ops);
+	  ops->mul += (cplx ? 2 : 1) * vl * m * a->taps;
+	  ops->add += (cplx ? 2 : 1) * vl * m * (a->taps - 1);
+	  pln->super.dft.super.pcost = nblk * cld->pcost + cldrest->pcost;
+     }
+     return &(pln->super.dft.super);
+
+ nada:
+     X(ifree)(buf);
+     X(plan_destroy_internal)(cldrest);
+     X(plan_destroy_internal)(cld);
+     return 0;
+}
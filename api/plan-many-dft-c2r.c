@@ -38,6 +38,16 @@ X(plan) X(plan_many_dft_c2r)(int rank, const int *n,
      EXTRACT_REIM(FFT_SIGN, in, &ri, &ii);
      inplace = out == ri;
 
+     if (flags & FFTW_PACKED) {
+	  /* the output overwrites the input, without padding */
+	  if (!inplace) return 0;
+	  return X(mkapiplan_composite)(
+	       0, flags,
+	       X(mkproblem_rdft2_packed)(rank, n, onembed, ostride, odist, howmany,
+					 out, FFTW_BACKWARD, flags),
+	       X(mkplan_rdft2_packed), 0);
+     }
+
      if (!inplace)
 	  flags |= FFTW_DESTROY_INPUT;
      p = X(mkapiplan)(
@@ -38,6 +38,16 @@ X(plan) X(plan_many_dft_r2c)(int rank, const int *n,
      EXTRACT_REIM(FFT_SIGN, out, &ro, &io);
      inplace = in == ro;
 
+     if (flags & FFTW_PACKED) {
+	  /* the output overwrites the input, without padding */
+	  if (!inplace) return 0;
+	  return X(mkapiplan_composite)(
+	       0, flags,
+	       X(mkproblem_rdft2_packed)(rank, n, inembed, istride, idist, howmany,
+					 in, FFTW_FORWARD, flags),
+	       X(mkplan_rdft2_packed), 0);
+     }
+
      p = X(mkapiplan)(
 	  0, flags, 
 	  X(mkproblem_rdft2_d_3pointers)(
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Plan-memory manager.
+
+   The awake plans are kept in a list, most recently executed first,
+   together with the bytes of the tables (see shmtab.c) that were made
+   when each was awakened.  While a cap is set, the execute functions
+   move the plan to the front of the list, awakening it if it was
+   asleep, and the least recently executed plans are put to sleep
+   until the total is below the cap.
+
+   The accounting is approximate: a table borrowed from another plan
+   (see twiddle.c) is charged to the plan that made it, and is freed
+   only when all the plans using it are asleep. */
+
+#include "api.h"
+
+size_t X(plan_memory_cap) = 0;
+
+static apiplan *mru = 0, *lru = 0;
+static size_t resident = 0;
+static int nplans = 0, nasleep = 0, nsleeps = 0, nawakenings = 0;
+static double awaken_time = 0.0;
+
+static void link_front(apiplan *p)
+{
+     p->prev = 0;
+     p->next = mru;
+     if (mru)
+	  mru->prev = p;
+     else
+	  lru = p;
+     mru = p;
+}
+
+static void unlink_plan(apiplan *p)
+{
+     if (p->prev)
+	  p->prev->next = p->next;
+     else
+	  mru = p->next;
+     if (p->next)
+	  p->next->prev = p->prev;
+     else
+	  lru = p->prev;
+     p->prev = p->next = 0;
+}
+
+static void wake(apiplan *p)
+{
+     size_t b0 = X(shmtab_bytes);
+
+     X(plan_awake)(p->pln, p->wakefulness);
+     p->bytes = X(shmtab_bytes) - b0;
+     p->asleep = 0;
+     resident += p->bytes;
+     link_front(p);
+}
+
+static void sleep_plan(apiplan *p)
+{
+     unlink_plan(p);
+     X(plan_awake)(p->pln, SLEEPY);
+     p->asleep = 1;
+     resident -= p->bytes;
+}
+
+/* put the least recently executed plans, other than KEEP, to sleep
+   until we are below the cap */
+static void enforce(apiplan *keep)
+{
+     apiplan *p, *prev;
+
+     for (p = lru; p && X(plan_memory_cap) && resident > X(plan_memory_cap);
+	  p = prev) {
+	  prev = p->prev;
+	  if (p != keep && p->bytes > 0) {
+	       sleep_plan(p);
+	       ++nasleep;
+	       ++nsleeps;
+	  }
+     }
+}
+
+void X(apiplan_register)(apiplan *p)
+{
+     p->prev = p->next = 0;
+     wake(p);
+     ++nplans;
+     enforce(p);
+}
+
+void X(apiplan_unregister)(apiplan *p)
+{
+     if (p->asleep) {
+	  --nasleep;
+     } else {
+	  unlink_plan(p);
+	  X(plan_awake)(p->pln, SLEEPY);
+	  resident -= p->bytes;
+     }
+     --nplans;
+}
+
+void X(apiplan_touch)(apiplan *p)
+{
+     if (p == mru)
+	  return;
+
+     if (p->asleep) {
+	  crude_time begin = X(get_crude_time)();
+	  wake(p);
+	  awaken_time += X(crude_elapsed)(begin);
+	  ++nawakenings;
+	  --nasleep;
+     } else {
+	  unlink_plan(p);
+	  link_front(p);
+     }
+     enforce(p);
+}
+
+void X(set_plan_memory_cap)(size_t bytes)
+{
+     X(plan_memory_cap) = bytes;
+     enforce(0);
+}
+
+void X(plan_memory_stats)(X(memory_stats) *stats)
+{
+     stats->cap = X(plan_memory_cap);
+     stats->resident = resident;
+     stats->plans = nplans;
+     stats->asleep = nasleep;
+     stats->sleeps = nsleeps;
+     stats->awakenings = nawakenings;
+     stats->awaken_time = awaken_time;
+}
+
+void X(fprint_plan_memory_stats)(FILE *output_file)
+{
+     X(memory_stats) st;
+
+     X(plan_memory_stats)(&st);
+     fprintf(output_file, "%d plans, %d asleep, %lu bytes of tables "
+	     "resident (cap %lu)\n", st.plans, st.asleep,
+	     (unsigned long) st.resident, (unsigned long) st.cap);
+     fprintf(output_file, "%d sleeps, %d awakenings in %g s",
+	     st.sleeps, st.awakenings, st.awaken_time);
+     if (st.awakenings)
+	  fprintf(output_file, " (%g s each)",
+		  st.awaken_time / st.awakenings);
+     fprintf(output_file, "\n");
+}
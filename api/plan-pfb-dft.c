@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "api.h"
+#include "dft.h"
+
+X(plan) X(plan_pfb_dft)(int channels, int taps, const R *coeffs,
+			int howmany, C *in, C *out, int sign, unsigned flags)
+{
+     R *ri, *ii, *ro, *io;
+     pfb a;
+
+     if (channels < 1 || taps < 1 || howmany < 1) return 0;
+     if (in == out || (flags & FFTW_VARIABLE_HOWMANY)) return 0;
+
+     EXTRACT_REIM(sign, in, &ri, &ii);
+     EXTRACT_REIM(sign, out, &ro, &io);
+
+     a.m = channels;
+     a.taps = taps;
+     a.vl = howmany;
+     a.is = a.os = 2;
+     a.ovs = 2 * a.m;
+     a.h = coeffs;
+
+     return X(mkapiplan_composite)(
+	  sign, flags,
+	  X(mkproblem_dft_d)(X(mktensor_1d)(a.m, a.is, a.os),
+			     X(mktensor_1d)(a.vl, a.m * a.is, a.ovs),
+			     TAINT_UNALIGNED(ri, flags),
+			     TAINT_UNALIGNED(ii, flags),
+			     TAINT_UNALIGNED(ro, flags),
+			     TAINT_UNALIGNED(io, flags)),
+	  X(mkplan_pfb), &a);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "api.h"
+
+/* indexed by problem kind, see ifftw.h */
+static const char *const kind_names[PROBLEM_LAST] = {
+     "unsolvable", "dft", "rdft", "rdft2",
+     "mpi-dft", "mpi-rdft", "mpi-rdft2", "mpi-transpose"
+};
+
+/* Store the statistics of up to N solvers into STATS, in the order
+   in which they were registered, and return the number of solvers. */
+int X(planner_solver_stats)(X(solver_stats) *stats, int n)
+{
+     planner *plnr = X(the_planner)();
+     unsigned i;
+
+     for (i = 0; i < plnr->nslvdesc && (int) i < n; ++i) {
+	  const slvdesc *sp = plnr->slvdescs + i;
+	  X(solver_stats) *st = stats + i;
+	  st->name = sp->reg_nam;
+	  st->id = sp->reg_id;
+	  st->invocations = sp->ninvoke;
+	  st->plans = sp->nplan;
+	  st->measurements = sp->nmeasure;
+	  st->wins = sp->nwin;
+	  st->measure_time = sp->tmeasure;
+     }
+     return (int) plnr->nslvdesc;
+}
+
+/* Likewise for the problem kinds, except the unsolvable one */
+int X(planner_problem_stats)(X(problem_stats) *stats, int n)
+{
+     planner *plnr = X(the_planner)();
+     int i;
+
+     for (i = 0; i + 1 < PROBLEM_LAST && i < n; ++i) {
+	  const kindstat *ks = plnr->kstat + (i + 1);
+	  X(problem_stats) *st = stats + i;
+	  st->kind = kind_names[i + 1];
+	  st->problems = ks->nprob;
+	  st->hits = ks->hit;
+	  st->misses = ks->miss;
+	  st->searches = ks->nsearch;
+	  st->relaxed = ks->nrelax;
+	  st->timeouts = ks->ntimeout;
+     }
+     return PROBLEM_LAST - 1;
+}
+
+void X(reset_planner_stats)(void)
+{
+     X(planner_reset_stats)(X(the_planner)());
+}
+
+/* Human-readable summary: the problem kinds that were planned, and
+   the solvers that were invoked, most expensive first. */
+void X(fprint_planner_stats)(FILE *output_file)
+{
+     planner *plnr = X(the_planner)();
+     int nslv = X(planner_solver_stats)(0, 0);
+     int nkind = X(planner_problem_stats)(0, 0);
+     X(solver_stats) *ss;
+     X(problem_stats) *ps;
+     int i, j;
+
+     ss = (X(solver_stats) *) MALLOC(sizeof(X(solver_stats)) * nslv, OTHER);
+     ps = (X(problem_stats) *) MALLOC(sizeof(X(problem_stats)) * nkind,
+				      OTHER);
+     X(planner_solver_stats)(ss, nslv);
+     X(planner_problem_stats)(ps, nkind);
+
+     fprintf(output_file, "%d problems, %d plans evaluated, "
+	     "measured %g, estimated %g\n",
+	     plnr->nprob, plnr->nplan, plnr->pcost, plnr->epcost);
+
+     fprintf(output_file, "%-14s %8s %8s %8s %8s %8s %8s\n", "kind",
+	     "problems", "hits", "misses", "searches", "relaxed", "timeouts");
+     for (i = 0; i < nkind; ++i)
+	  if (ps[i].problems)
+	       fprintf(output_file, "%-14s %8d %8d %8d %8d %8d %8d\n",
+		       ps[i].kind, ps[i].problems, ps[i].hits,
+		       ps[i].misses, ps[i].searches, ps[i].relaxed,
+		       ps[i].timeouts);
+
+     /* insertion sort by measurement time, then by invocations */
+     for (i = 1; i < nslv; ++i) {
+	  X(solver_stats) t = ss[i];
+	  for (j = i; j > 0 && (ss[j - 1].measure_time < t.measure_time ||
+				(ss[j - 1].measure_time == t.measure_time &&
+				 ss[j - 1].invocations < t.invocations));
+	       --j)
+	       ss[j] = ss[j - 1];
+	  ss[j] = t;
+     }
+
+     fprintf(output_file, "%-40s %8s %8s %8s %8s %10s\n", "solver",
+	     "invoked", "plans", "measured", "wins", "time (s)");
+     for (i = 0; i < nslv && ss[i].invocations; ++i)
+	  fprintf(output_file, "%-36s %3d %8d %8d %8d %8d %10.4g\n",
+		  ss[i].name, ss[i].id, ss[i].invocations, ss[i].plans,
+		  ss[i].measurements, ss[i].wins, ss[i].measure_time);
+
+     X(ifree)(ps);
+     X(ifree)(ss);
+}
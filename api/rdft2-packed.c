@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* In-place r2c/c2r transforms without padding (FFTW_PACKED).
+
+   The complex output of an r2c transform of a real array of size
+   n[0] x ... x n[d-1] is stored in the array itself.  Let m = n[d-1].
+   Each row of m reals holds the complex outputs X[k] for
+   1 <= k < (m+1)/2 as interleaved pairs (re, im), starting at element
+   2 for even m and at element 1 for odd m.  Element 0 of the rows
+   holds the k = 0 outputs, and for even m element 1 holds the
+   k = m/2 outputs.  These are real along the last dimension only, so
+   they are stored in the (separable) halfcomplex format of the r2r
+   R2HC transform along the other dimensions.  For d = 1 this is the
+   usual packed format of real FFTs.
+
+   The transform is the composition of three ordinary transforms,
+   planned separately: an in-place R2HC of every row (followed by a
+   permutation of the row from halfcomplex to packed order), a DFT
+   along the first d-1 dimensions of the complex columns, and an
+   R2HC along the first d-1 dimensions of the one or two real
+   columns.  The c2r transform undoes these in the opposite order.
+
+   The problem is an rdft2 problem with R0 == CR, whose strides are
+   the strides of the real array for both the input and the output.
+   It is never given to the planner: only its children are. */
+
+#include "api.h"
+#include "dft.h"
+#include "rdft.h"
+
+typedef struct {
+     plan_rdft2 super;
+
+     plan *cldrows, *cldcols, *cld0;
+     tensor *rowsz;		/* the rows of the array */
+     INT m, s;			/* size and stride of the rows */
+     INT ro, io;		/* offsets of the complex columns */
+} P;
+
+static void hc2packed(const P *ego, R *x, R *b)
+{
+     INT k, m = ego->m, s = ego->s, p;
+
+     for (k = 0; k < m; ++k)
+	  b[k] = x[k * s];
+     if (!(m & 1))
+	  x[s] = b[m / 2];
+     for (k = 1, p = 2 - (m & 1); 2 * k < m; ++k, p += 2) {
+	  x[p * s] = b[k];
+	  x[(p + 1) * s] = b[m - k];
+     }
+}
+
+static void packed2hc(const P *ego, R *x, R *b)
+{
+     INT k, m = ego->m, s = ego->s, p;
+
+     b[0] = x[0];
+     if (!(m & 1))
+	  b[m / 2] = x[s];
+     for (k = 1, p = 2 - (m & 1); 2 * k < m; ++k, p += 2) {
+	  b[k] = x[p * s];
+	  b[m - k] = x[(p + 1) * s];
+     }
+     for (k = 1; k < m; ++k)
+	  x[k * s] = b[k];
+}
+
+static void rows(const P *ego, const iodim *d, int rnk, R *x, R *b,
+		 void (*f)(const P *, R *, R *))
+{
+     if (rnk == 0)
+	  f(ego, x, b);
+     else {
+	  INT i, n = d[0].n, is = d[0].is;
+	  for (i = 0; i < n; ++i)
+	       rows(ego, d + 1, rnk - 1, x + i * is, b, f);
+     }
+}
+
+static void permute(const P *ego, R *x, void (*f)(const P *, R *, R *))
+{
+     R *b;
+
+     if (!FINITE_RNK(ego->rowsz->rnk) || ego->m < 3)
+	  return; /* nothing to permute */
+     b = (R *) MALLOC(sizeof(R) * ego->m, BUFFERS);
+     rows(ego, ego->rowsz->dims, ego->rowsz->rnk, x, b, f);
+     X(ifree)(b);
+}
+
+static void apply_columns(const P *ego, R *x)
+{
+     if (ego->cldcols) {
+	  plan_dft *cld = (plan_dft *) ego->cldcols;
+	  cld->apply((plan *) cld, x + ego->ro, x + ego->io,
+		     x + ego->ro, x + ego->io);
+     }
+     if (ego->cld0) {
+	  plan_rdft *cld = (plan_rdft *) ego->cld0;
+	  cld->apply((plan *) cld, x, x);
+     }
+}
+
+static void apply_r2hc(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_rdft *cld = (plan_rdft *) ego->cldrows;
+     UNUSED(r1); UNUSED(cr); UNUSED(ci);
+
+     cld->apply((plan *) cld, r0, r0);
+     permute(ego, r0, hc2packed);
+     apply_columns(ego, r0);
+}
+
+static void apply_hc2r(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_rdft *cld = (plan_rdft *) ego->cldrows;
+     UNUSED(r1); UNUSED(cr); UNUSED(ci);
+
+     apply_columns(ego, r0);
+     permute(ego, r0, packed2hc);
+     cld->apply((plan *) cld, r0, r0);
+}
+
+static void awake(plan *ego_, enum wakefulness wakefulness)
+{
+     P *ego = (P *) ego_;
+
+     X(plan_awake)(ego->cldrows, wakefulness);
+     X(plan_awake)(ego->cldcols, wakefulness);
+     X(plan_awake)(ego->cld0, wakefulness);
+}
+
+static void destroy(plan *ego_)
+{
+     P *ego = (P *) ego_;
+
+     X(plan_destroy_internal)(ego->cld0);
+     X(plan_destroy_internal)(ego->cldcols);
+     X(plan_destroy_internal)(ego->cldrows);
+     X(tensor_destroy)(ego->rowsz);
+}
+
+static void print(const plan *ego_, printer *p)
+{
+     const P *ego = (const P *) ego_;
+
+     p->print(p, "(rdft2-packed-%D%(%p%)%(%p%)%(%p%))",
+	      ego->m, ego->cldrows, ego->cldcols, ego->cld0);
+}
+
+static int same_strides(const tensor *t)
+{
+     int i;
+
+     if (!FINITE_RNK(t->rnk))
+	  return 1;
+     for (i = 0; i < t->rnk; ++i)
+	  if (t->dims[i].is != t->dims[i].os)
+	       return 0;
+     return 1;
+}
+
+static int applicable(const problem *p_)
+{
+     const problem_rdft2 *p = (const problem_rdft2 *) p_;
+
+     return (1
+	     && p_->adt->problem_kind == PROBLEM_RDFT2
+	     && (p->kind == R2HC || p->kind == HC2R)
+	     && UNTAINT(p->r0) == UNTAINT(p->cr)
+	     && same_strides(p->sz)
+	     && same_strides(p->vecsz)
+	  );
+}
+
+/* N columns of stride S, for each vector of VECSZ */
+static tensor *vector(INT n, INT s, const tensor *vecsz)
+{
+     tensor *t = X(mktensor_1d)(n, s, s);
+     tensor *v = X(tensor_append)(t, vecsz);
+     X(tensor_destroy)(t);
+     return v;
+}
+
+static plan *mkchild(planner *plnr, unsigned flags, problem *prb,
+		     int hash_info, mkplan_fn mk)
+{
+     plan *pln = mk(plnr, flags, prb, hash_info);
+     X(problem_destroy)(prb);
+     return pln;
+}
+
+plan *X(mkplan_rdft2_packed)(planner *plnr, unsigned flags,
+			     const problem *p_, int hash_info, mkplan_fn mk,
+			     const void *arg)
+{
+     const problem_rdft2 *p = (const problem_rdft2 *) p_;
+     plan *cldrows = 0, *cldcols = 0, *cld0 = 0;
+     tensor *colsz = 0, *rowsz;
+     R *x = p->r0;
+     int d, r2hc = p->kind == R2HC;
+     INT m, s, nc, ro, io;
+     P *pln;
+
+     static const plan_adt padt = {
+	  X(rdft2_solve), awake, print, destroy
+     };
+
+     UNUSED(arg);
+     if (!applicable(p_))
+	  return 0;
+
+     if ((d = p->sz->rnk) > 0) {
+	  m = p->sz->dims[d - 1].n;
+	  s = p->sz->dims[d - 1].is;
+	  colsz = X(tensor_copy_sub)(p->sz, 0, d - 1);
+     } else { /* a size-1 transform, compressed away */
+	  m = s = 1;
+	  colsz = X(mktensor_0d)();
+     }
+     nc = (m - 1) / 2;		/* number of complex columns */
+     ro = (2 - (m & 1)) * s;	/* offset of the first one */
+     io = ro + s;
+     if (!r2hc) {
+	  /* the backward DFT swaps the real and imaginary parts */
+	  INT t = ro; ro = io; io = t;
+     }
+
+     rowsz = X(tensor_append)(colsz, p->vecsz);
+
+     cldrows = mkchild(plnr, flags,
+		       X(mkproblem_rdft_1_d)(X(mktensor_1d)(m, s, s),
+					     X(tensor_copy)(rowsz),
+					     x, x, p->kind),
+		       hash_info, mk);
+     if (!cldrows) goto nada;
+
+     if (d > 1 && nc > 0) {
+	  cldcols = mkchild(plnr, flags,
+			    X(mkproblem_dft_d)(X(tensor_copy)(colsz),
+					       vector(nc, 2 * s, p->vecsz),
+					       TAINT(x + ro, ro),
+					       TAINT(x + io, io),
+					       TAINT(x + ro, ro),
+					       TAINT(x + io, io)),
+			    hash_info, mk);
+	  if (!cldcols) goto nada;
+     }
+
+     if (d > 1) {
+	  rdft_kind *kind = (rdft_kind *) MALLOC(sizeof(rdft_kind) * (d - 1),
+						 PROBLEMS);
+	  int i;
+	  for (i = 0; i < d - 1; ++i)
+	       kind[i] = p->kind;
+	  cld0 = mkchild(plnr, flags,
+			 X(mkproblem_rdft_d)(X(tensor_copy)(colsz),
+					     vector(2 - (m & 1), s, p->vecsz),
+					     x, x, kind),
+			 hash_info, mk);
+	  X(ifree)(kind);
+	  if (!cld0) goto nada;
+     }
+
+     X(tensor_destroy)(colsz);
+
+     pln = MKPLAN_RDFT2(P, &padt, r2hc ? apply_r2hc : apply_hc2r);
+     pln->cldrows = cldrows;
+     pln->cldcols = cldcols;
+     pln->cld0 = cld0;
+     pln->rowsz = rowsz;
+     pln->m = m;
+     pln->s = s;
+     pln->ro = ro;
+     pln->io = io;
+
+     X(ops_cpy)(&cldrows->ops, &pln->super.super.ops);
+     pln->super.super.pcost = cldrows->pcost;
+     if (cldcols) {
+	  X(ops_add2)(&cldcols->ops, &pln->super.super.ops);
+	  pln->super.super.pcost += cldcols->pcost;
+     }
+     if (cld0) {
+	  X(ops_add2)(&cld0->ops, &pln->super.super.ops);
+	  pln->super.super.pcost += cld0->pcost;
+     }
+     return &(pln->super.super);
+
+ nada:
+     X(plan_destroy_internal)(cld0);
+     X(plan_destroy_internal)(cldcols);
+     X(plan_destroy_internal)(cldrows);
+     X(tensor_destroy2)(rowsz, colsz);
+     return 0;
+}
+
+/* the problem for the advanced interface: the array R of HOWMANY
+   transforms, of size N and layout NEMBED, STRIDE, DIST (in real
+   numbers), both for the input and for the output */
+problem *X(mkproblem_rdft2_packed)(int rank, const int *n,
+				   const int *nembed, int stride, int dist,
+				   int howmany, R *r, int sign,
+				   unsigned flags)
+{
+     r = TAINT_UNALIGNED(r, flags);
+     return X(mkproblem_rdft2_d)(
+	  X(mktensor_rowmajor)(rank, n, nembed ? nembed : n,
+			       nembed ? nembed : n, stride, stride),
+	  X(mktensor_1d)(howmany, dist, dist),
+	  r, r + stride, r, r + 1,
+	  sign == FFTW_FORWARD ? R2HC : HC2R);
+}
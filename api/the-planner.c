@@ -39,6 +39,8 @@ void X(cleanup)(void)
           X(planner_destroy)(plnr);
           plnr = 0;
      }
+     X(shmtab_set_dir)(0);
+     X(arena_cleanup)();
 }
 
 void X(set_timelimit)(double tlim) 
@@ -47,3 +49,21 @@ void X(set_timelimit)(double tlim)
 	called, so use X(the_planner)() */
      X(the_planner)()->timelimit = tlim; 
 }
+
+int X(set_shared_tables)(const char *directory)
+{
+     return X(shmtab_set_dir)(directory);
+}
+
+int X(plan_with_arena)(unsigned flags)
+{
+     unsigned aflags = 0;
+
+     if (flags & (FFTW_ARENA_ON | FFTW_ARENA_LOCK | FFTW_ARENA_HUGEPAGE))
+	  aflags |= ARENA_ON;
+     if (flags & FFTW_ARENA_LOCK)
+	  aflags |= ARENA_LOCK;
+     if (flags & FFTW_ARENA_HUGEPAGE)
+	  aflags |= ARENA_HUGEPAGE;
+     return X(arena_set_flags)(aflags);
+}
@@ -29,6 +29,9 @@
 #elif defined(FFTW_QUAD)
 #  define x77(name) CONCAT(qfftw_, name)
 #  define X77(NAME) CONCAT(QFFTW_, NAME)
+#elif defined(FFTW_DDOUBLE)
+#  define x77(name) CONCAT(ddfftw_, name)
+#  define X77(NAME) CONCAT(DDFFTW_, NAME)
 #else
 #  define x77(name) CONCAT(dfftw_, name)
 #  define X77(NAME) CONCAT(DFFTW_, NAME)
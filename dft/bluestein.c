@@ -49,18 +49,25 @@ static void bluestein_sequence(enum wakefulness wakefulness, INT n, R *w)
      X(triggen_destroy)(t);
 }
 
-static void mktwiddle(enum wakefulness wakefulness, P *p)
+typedef struct {
+     enum wakefulness wakefulness;
+     P *p;
+} closure;
+
+static void fill_w(R *w, void *data)
+{
+     const closure *c = (const closure *) data;
+     bluestein_sequence(c->wakefulness, c->p->n, w);
+}
+
+static void fill_W(R *W, void *data)
 {
+     const closure *c = (const closure *) data;
      INT i;
-     INT n = p->n, nb = p->nb;
-     R *w, *W;
+     INT n = c->p->n, nb = c->p->nb;
+     const R *w = c->p->w;
      E nbf = (E)nb;
 
-     p->w = w = (R *) MALLOC(2 * n * sizeof(R), TWIDDLES);
-     p->W = W = (R *) MALLOC(2 * nb * sizeof(R), TWIDDLES);
-
-     bluestein_sequence(wakefulness, n, w);
-
      for (i = 0; i < nb; ++i)
           W[2*i] = W[2*i+1] = K(0.0);
 
@@ -73,12 +80,34 @@ static void mktwiddle(enum wakefulness wakefulness, P *p)
      }
 
      {
-          plan_dft *cldf = (plan_dft *)p->cldf;
+          plan_dft *cldf = (plan_dft *)c->p->cldf;
 	  /* cldf must be awake */
-          cldf->apply(p->cldf, W, W+1, W, W+1);
+          cldf->apply(c->p->cldf, W, W+1, W, W+1);
      }
 }
 
+static void mktwiddle(enum wakefulness wakefulness, P *p)
+{
+     closure c;
+     md5 key;
+
+     c.wakefulness = wakefulness;
+     c.p = p;
+
+     X(md5begin)(&key);
+     X(md5puts)(&key, "bluestein-w");
+     X(md5int)(&key, (int) wakefulness);
+     X(md5INT)(&key, p->n);
+     p->w = X(shmtab_mk)(&key, 2 * p->n, fill_w, &c);
+
+     X(md5begin)(&key);
+     X(md5puts)(&key, "bluestein-W");
+     X(md5int)(&key, (int) wakefulness);
+     X(md5INT)(&key, p->n);
+     X(md5INT)(&key, p->nb);
+     p->W = X(shmtab_mk)(&key, 2 * p->nb, fill_W, &c);
+}
+
 static void apply(const plan *ego_, R *ri, R *ii, R *ro, R *io)
 {
      const P *ego = (const P *) ego_;
@@ -135,8 +164,8 @@ static void awake(plan *ego_, enum wakefulness wakefulness)
 
      switch (wakefulness) {
 	 case SLEEPY:
-	      X(ifree0)(ego->w); ego->w = 0;
-	      X(ifree0)(ego->W); ego->W = 0;
+	      X(shmtab_free)(ego->w); ego->w = 0;
+	      X(shmtab_free)(ego->W); ego->W = 0;
 	      break;
 	 default:
 	      A(!ego->w);
@@ -19,19 +19,36 @@
  */
 
 
+/* Transforms of a vector of lines through a buffer of NBUF lines.
+
+   Ordinarily the lines are transformed into the buffer and copied
+   back.  The tiled solvers are for lines along a strided axis that are
+   adjacent in memory: reading them with the transform stride touches
+   a new cache line (and often a new page) for every element, so
+   instead a tile of adjacent lines is gathered into the buffer with a
+   rank-0 plan, transformed there in place, and copied back.  The tile
+   is sized to fit in the cache, so that the transform and the copy
+   find it there. */
+
 #include "dft.h"
 
 typedef struct {
      solver super;
      int maxnbuf_ndx;
+     int tiled;
 } S;
 
 static const INT maxnbufs[] = { 8, 256 };
 
+/* bytes per tile for the tiled solvers, roughly an L1 and an L2
+   cache; one for each element of MAXNBUFS */
+static const INT tilebytes[] = { 32 * 1024, 256 * 1024 };
+
 typedef struct {
      plan_dft super;
 
      plan *cld, *cldcpy, *cldrest;
+     plan *cldgather;		/* tiled only */
      INT n, vl, nbuf, bufdist;
      INT ivs_by_nbuf, ovs_by_nbuf;
      INT roffset, ioffset;
@@ -68,11 +85,43 @@ static void apply(const plan *ego_, R *ri, R *ii, R *ro, R *io)
      cldrest->apply((plan *) cldrest, ri, ii, ro, io);
 }
 
+/* gather a tile into bufs, transform it there, and copy it back */
+static void apply_tiled(const plan *ego_, R *ri, R *ii, R *ro, R *io)
+{
+     const P *ego = (const P *) ego_;
+     INT nbuf = ego->nbuf;
+     R *bufs = (R *)MALLOC(sizeof(R) * nbuf * ego->bufdist * 2, BUFFERS);
+     R *br = bufs + ego->roffset, *bi = bufs + ego->ioffset;
+
+     plan_dft *cldgather = (plan_dft *) ego->cldgather;
+     plan_dft *cld = (plan_dft *) ego->cld;
+     plan_dft *cldcpy = (plan_dft *) ego->cldcpy;
+     plan_dft *cldrest;
+     INT i, vl = ego->vl;
+     INT ivs_by_nbuf = ego->ivs_by_nbuf, ovs_by_nbuf = ego->ovs_by_nbuf;
+
+     for (i = nbuf; i <= vl; i += nbuf) {
+	  cldgather->apply((plan *) cldgather, ri, ii, br, bi);
+	  ri += ivs_by_nbuf; ii += ivs_by_nbuf;
+
+	  cld->apply((plan *) cld, br, bi, br, bi);
+
+	  cldcpy->apply((plan *) cldcpy, br, bi, ro, io);
+	  ro += ovs_by_nbuf; io += ovs_by_nbuf;
+     }
+
+     X(ifree)(bufs);
+
+     /* Do the remaining transforms, if any: */
+     cldrest = (plan_dft *) ego->cldrest;
+     cldrest->apply((plan *) cldrest, ri, ii, ro, io);
+}
 
 static void awake(plan *ego_, enum wakefulness wakefulness)
 {
      P *ego = (P *) ego_;
 
+     X(plan_awake)(ego->cldgather, wakefulness);
      X(plan_awake)(ego->cld, wakefulness);
      X(plan_awake)(ego->cldcpy, wakefulness);
      X(plan_awake)(ego->cldrest, wakefulness);
@@ -84,15 +133,31 @@ static void destroy(plan *ego_)
      X(plan_destroy_internal)(ego->cldrest);
      X(plan_destroy_internal)(ego->cldcpy);
      X(plan_destroy_internal)(ego->cld);
+     X(plan_destroy_internal)(ego->cldgather);
 }
 
 static void print(const plan *ego_, printer *p)
 {
      const P *ego = (const P *) ego_;
-     p->print(p, "(dft-buffered-%D%v/%D-%D%(%p%)%(%p%)%(%p%))",
-              ego->n, ego->nbuf,
-              ego->vl, ego->bufdist % ego->n,
-              ego->cld, ego->cldcpy, ego->cldrest);
+     if (ego->cldgather)
+	  p->print(p, "(dft-buffered-tiled-%D%v/%D-%D%(%p%)%(%p%)%(%p%)%(%p%))",
+		   ego->n, ego->nbuf,
+		   ego->vl, ego->bufdist % ego->n,
+		   ego->cldgather, ego->cld, ego->cldcpy, ego->cldrest);
+     else
+	  p->print(p, "(dft-buffered-%D%v/%D-%D%(%p%)%(%p%)%(%p%))",
+		   ego->n, ego->nbuf,
+		   ego->vl, ego->bufdist % ego->n,
+		   ego->cld, ego->cldcpy, ego->cldrest);
+}
+
+/* the maximum number of buffers of solver NDX of EGO's kind, for
+   lines of size N */
+static INT maxnbuf(const S *ego, int ndx, INT n)
+{
+     if (ego->tiled)
+	  return X(imax)(1, tilebytes[ndx] / (2 * n * (INT) sizeof(R)));
+     return maxnbufs[ndx];
 }
 
 static int applicable0(const S *ego, const problem *p_, const planner *plnr)
@@ -104,7 +169,8 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	 && p->vecsz->rnk <= 1
 	 && p->sz->rnk == 1
 	  ) {
-	  INT vl, ivs, ovs;
+	  INT vl, ivs, ovs, mnb[NELEM(maxnbufs)];
+	  int i;
 	  X(tensor_tornk1)(p->vecsz, &vl, &ivs, &ovs);
 
 	  if (X(toobig)(p->sz->dims[0].n) && CONSERVE_MEMORYP(plnr))
@@ -113,20 +179,34 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	  /* if this solver is redundant, in the sense that a solver
 	     of lower index generates the same plan, then prune this
 	     solver */
+	  for (i = 0; i < (int) NELEM(maxnbufs); ++i)
+	       mnb[i] = maxnbuf(ego, i, d[0].n);
 	  if (X(nbuf_redundant)(d[0].n, vl, 
 				ego->maxnbuf_ndx,
-				maxnbufs, NELEM(maxnbufs)))
+				mnb, NELEM(maxnbufs)))
 	       return 0;
 
-	  /*
-	    In principle, the buffered transforms might be useful
-	    when working out of place.  However, in order to
-	    prevent infinite loops in the planner, we require
-	    that the output stride of the buffered transforms be
-	    greater than 2.
-	  */
-	  if (p->ri != p->ro)
+	  if (ego->tiled) {
+	       /* the lines are adjacent, and the transform is strided */
+	       if (!(1
+		     && p->vecsz->rnk == 1
+		     && vl > 1
+		     && X(iabs)(ivs) < X(iabs)(d[0].is)
+		     && X(iabs)(ovs) < X(iabs)(d[0].os)))
+		    return 0;
+
+	       if (p->ri != p->ro)
+		    return 1;
+	  } else if (p->ri != p->ro) {
+	       /*
+		 In principle, the buffered transforms might be useful
+		 when working out of place.  However, in order to
+		 prevent infinite loops in the planner, we require
+		 that the output stride of the buffered transforms be
+		 greater than 2.
+	       */
 	       return (d[0].os > 2);
+	  }
 
 	  /*
 	   * If the problem is in place, the input/output strides must
@@ -139,7 +219,7 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	       ((p->vecsz->rnk == 0)
 		||
 		(X(nbuf)(d[0].n, p->vecsz->dims[0].n, 
-			 maxnbufs[ego->maxnbuf_ndx]) 
+			 mnb[ego->maxnbuf_ndx]) 
 		 == p->vecsz->dims[0].n)))
 	       return 1;
      }
@@ -152,7 +232,7 @@ static int applicable(const S *ego, const problem *p_, const planner *plnr)
      if (NO_BUFFERINGP(plnr)) return 0;
      if (!applicable0(ego, p_, plnr)) return 0;
 
-     if (NO_UGLYP(plnr)) {
+     if (NO_UGLYP(plnr) && !ego->tiled) {
 	  const problem_dft *p = (const problem_dft *) p_;
 	  if (p->ri != p->ro) return 0;
 	  if (X(toobig)(p->sz->dims[0].n)) return 0;
@@ -167,6 +247,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      plan *cld = (plan *) 0;
      plan *cldcpy = (plan *) 0;
      plan *cldrest = (plan *) 0;
+     plan *cldgather = (plan *) 0;
      const problem_dft *p = (const problem_dft *) p_;
      R *bufs = (R *) 0;
      INT nbuf = 0, bufdist, n, vl;
@@ -183,7 +264,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
 
      X(tensor_tornk1)(p->vecsz, &vl, &ivs, &ovs);
 
-     nbuf = X(nbuf)(n, vl, maxnbufs[ego->maxnbuf_ndx]);
+     nbuf = X(nbuf)(n, vl, maxnbuf(ego, ego->maxnbuf_ndx, n));
      bufdist = X(bufdist)(n, vl);
      A(nbuf > 0);
 
@@ -195,16 +276,38 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      /* initial allocation for the purpose of planning */
      bufs = (R *) MALLOC(sizeof(R) * nbuf * bufdist * 2, BUFFERS);
 
-     /* allow destruction of input if problem is in place */
-     cld = X(mkplan_f_d)(plnr,
-			 X(mkproblem_dft_d)(
-			      X(mktensor_1d)(n, p->sz->dims[0].is, 2),
-			      X(mktensor_1d)(nbuf, ivs, bufdist * 2),
-			      TAINT(p->ri, ivs * nbuf),
-			      TAINT(p->ii, ivs * nbuf),
-			      bufs + roffset, 
-			      bufs + ioffset),
-			 0, 0, (p->ri == p->ro) ? NO_DESTROY_INPUT : 0);
+     if (ego->tiled) {
+	  /* gathering the tile is a rank-0 transform (a transposition) */
+	  cldgather = X(mkplan_d)(plnr,
+				  X(mkproblem_dft_d)(
+				       X(mktensor_0d)(),
+				       X(mktensor_2d)(nbuf, ivs, bufdist * 2,
+						      n, p->sz->dims[0].is, 2),
+				       TAINT(p->ri, ivs * nbuf),
+				       TAINT(p->ii, ivs * nbuf),
+				       bufs + roffset, 
+				       bufs + ioffset));
+	  if (!cldgather)
+	       goto nada;
+
+	  cld = X(mkplan_d)(plnr,
+			    X(mkproblem_dft_d)(
+				 X(mktensor_1d)(n, 2, 2),
+				 X(mktensor_1d)(nbuf, bufdist * 2, bufdist * 2),
+				 bufs + roffset, bufs + ioffset,
+				 bufs + roffset, bufs + ioffset));
+     } else {
+	  /* allow destruction of input if problem is in place */
+	  cld = X(mkplan_f_d)(plnr,
+			      X(mkproblem_dft_d)(
+				   X(mktensor_1d)(n, p->sz->dims[0].is, 2),
+				   X(mktensor_1d)(nbuf, ivs, bufdist * 2),
+				   TAINT(p->ri, ivs * nbuf),
+				   TAINT(p->ii, ivs * nbuf),
+				   bufs + roffset, 
+				   bufs + ioffset),
+			      0, 0, (p->ri == p->ro) ? NO_DESTROY_INPUT : 0);
+     }
      if (!cld)
           goto nada;
 
@@ -238,7 +341,8 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      if (!cldrest)
           goto nada;
 
-     pln = MKPLAN_DFT(P, &padt, apply);
+     pln = MKPLAN_DFT(P, &padt, cldgather ? apply_tiled : apply);
+     pln->cldgather = cldgather;
      pln->cld = cld;
      pln->cldcpy = cldcpy;
      pln->cldrest = cldrest;
@@ -255,6 +359,8 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      {
 	  opcnt t;
 	  X(ops_add)(&cld->ops, &cldcpy->ops, &t);
+	  if (cldgather)
+	       X(ops_add2)(&cldgather->ops, &t);
 	  X(ops_madd)(vl / nbuf, &t, &cldrest->ops, &pln->super.super.ops);
      }
 
@@ -265,14 +371,16 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      X(plan_destroy_internal)(cldrest);
      X(plan_destroy_internal)(cldcpy);
      X(plan_destroy_internal)(cld);
+     X(plan_destroy_internal)(cldgather);
      return (plan *) 0;
 }
 
-static solver *mksolver(int maxnbuf_ndx)
+static solver *mksolver(int maxnbuf_ndx, int tiled)
 {
      static const solver_adt sadt = { PROBLEM_DFT, mkplan, 0 };
      S *slv = MKSOLVER(S, &sadt);
      slv->maxnbuf_ndx = maxnbuf_ndx;
+     slv->tiled = tiled;
      return &(slv->super);
 }
 
@@ -280,5 +388,7 @@ void X(dft_buffered_register)(planner *p)
 {
      size_t i;
      for (i = 0; i < NELEM(maxnbufs); ++i)
-	  REGISTER_SOLVER(p, mksolver(i));
+	  REGISTER_SOLVER(p, mksolver(i, 0));
+     for (i = 0; i < NELEM(tilebytes); ++i)
+	  REGISTER_SOLVER(p, mksolver(i, 1));
 }
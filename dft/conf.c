@@ -29,6 +29,7 @@ static const solvtab s =
      SOLVTAB(X(dft_vrank_geq1_register)),
      SOLVTAB(X(dft_buffered_register)),
      SOLVTAB(X(dft_generic_register)),
+     SOLVTAB(X(dft_generic_batch_register)),
      SOLVTAB(X(dft_rader_register)),
      SOLVTAB(X(dft_bluestein_register)),
      SOLVTAB(X(dft_nop_register)),
@@ -253,3 +253,49 @@ plan *X(mkplan_dftw)(size_t size, const plan_adt *adt, dftwapply apply)
 
      return &(ego->super);
 }
+
+int X(ct_prefetch_applicable)(INT pfdist, INT r, INT m,
+			      const planner *plnr)
+{
+     return (pfdist == 0
+	     || (1
+		 /* the distance can only be chosen by timing */
+		 && !ESTIMATEP(plnr)
+
+		 /* in-cache passes don't need any help */
+		 && r * m >= CT_PREFETCH_MINSZ));
+}
+
+/* prefetch the R rows of iterations [mb, me) of a twiddle pass,
+   together with their twiddle factors.  X(mktwiddle) lays the table
+   out in blocks of NTWIDDLE reals, one block for every VL consecutive
+   iterations, where NTWIDDLE and VL are X(twiddle_length) and
+   X(twiddle_vl) of the codelet's twiddle program; this is also how
+   the codelets step through it.  MB is a multiple of VL, since the
+   codelets only start at such iterations. */
+void X(ct_prefetch)(const R *rio, const R *iio, INT r, INT rs,
+		    INT mb, INT me, INT ms,
+		    const R *W, INT ntwiddle, INT vl)
+{
+     INT k, j, step, as = ms < 0 ? -ms : ms;
+     const R *w, *we;
+     int splitp = (iio - rio >= (INT)(CACHELINE / sizeof(R))
+		   || rio - iio >= (INT)(CACHELINE / sizeof(R)));
+
+     /* one prefetch per cache line along m */
+     step = (as * (INT)sizeof(R) >= CACHELINE) ? 1 :
+	  (INT)(CACHELINE / sizeof(R)) / (as ? as : 1);
+
+     for (k = 0; k < r; ++k, rio += rs, iio += rs) {
+	  for (j = mb; j < me; j += step) {
+	       PREFETCHW(rio + j * ms);
+	       if (splitp)
+		    PREFETCHW(iio + j * ms);
+	  }
+     }
+
+     A(mb % vl == 0);
+     for (w = W + (mb / vl) * ntwiddle, we = W + (me / vl) * ntwiddle;
+	  w < we; w += CACHELINE / sizeof(R))
+	  PREFETCH(w);
+}
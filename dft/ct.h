@@ -59,6 +59,22 @@ ct_solver *X(mksolver_ct)(size_t size, INT r, int dec,
 extern ct_solver *(*X(mksolver_ct_hook))(size_t, INT, int, 
 					 ct_mkinferior, ct_force_vrecursion);
 
+/* software prefetch in the twiddle passes: the m loop is cut into
+   blocks of CT_PREFETCH_BLOCK iterations, and the rows and twiddles of
+   the block CT_PREFETCH_DIST blocks ahead are prefetched before each
+   codelet call.  The planner times one prefetching variant of each
+   solver against the plain one; a single distance keeps that to one
+   extra candidate per codelet. */
+#define CT_PREFETCH_BLOCK 16
+#define CT_PREFETCH_DIST 2
+#define CT_PREFETCH_MINSZ 65536 /* r * m below which the pass is in cache */
+
+int X(ct_prefetch_applicable)(INT pfdist, INT r, INT m,
+			      const planner *plnr);
+void X(ct_prefetch)(const R *rio, const R *iio, INT r, INT rs,
+		    INT mb, INT me, INT ms,
+		    const R *W, INT ntwiddle, INT vl);
+
 void X(regsolver_ct_directw)(planner *plnr,
      kdftw codelet, const ct_desc *desc, int dec);
 void X(regsolver_ct_directwbuf)(planner *plnr,
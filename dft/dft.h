@@ -72,6 +72,7 @@ void X(dft_vrank2_transpose_register)(planner *p);
 void X(dft_vrank3_transpose_register)(planner *p);
 void X(dft_buffered_register)(planner *p);
 void X(dft_generic_register)(planner *p);
+void X(dft_generic_batch_register)(planner *p);
 void X(dft_rader_register)(planner *p);
 void X(dft_bluestein_register)(planner *p);
 void X(dft_nop_register)(planner *p);
@@ -25,6 +25,7 @@ typedef struct {
      ct_solver super;
      const ct_desc *desc;
      int bufferedp;
+     INT pfdist;
      kdftw k;
 } S;
 
@@ -34,6 +35,7 @@ typedef struct {
      INT r;
      stride rs;
      INT m, ms, v, vs, mb, me, extra_iter;
+     INT pfdist, ntwiddle, twvl;
      stride brs;
      twid *td;
      const S *slv;
@@ -69,6 +71,32 @@ static void apply_extra_iter(const plan *ego_, R *rio, R *iio)
      }
 }
 
+static void prefetch(const P *ego, R *rio, R *iio, INT mb, INT me)
+{
+     X(ct_prefetch)(rio, iio, ego->r, WS(ego->rs, 1), mb, me, ego->ms,
+		    ego->td->W, ego->ntwiddle, ego->twvl);
+}
+
+/* the m loop in blocks, prefetching the block PFDIST blocks ahead */
+static void apply_pf(const plan *ego_, R *rio, R *iio)
+{
+     const P *ego = (const P *) ego_;
+     INT i, j, v = ego->v, vs = ego->vs;
+     INT mb = ego->mb, me = ego->me, ms = ego->ms;
+     INT blk = CT_PREFETCH_BLOCK, d = ego->pfdist * CT_PREFETCH_BLOCK;
+     ASSERT_ALIGNED_DOUBLE;
+     for (i = 0; i < v; ++i, rio += vs, iio += vs) {
+	  for (j = mb; j < me; j += blk) {
+	       INT je = (j + blk < me) ? j + blk : me;
+	       if (j + d < me)
+		    prefetch(ego, rio, iio, j + d,
+			     (j + d + blk < me) ? j + d + blk : me);
+	       ego->k(rio + j*ms, iio + j*ms, ego->td->W,
+		      ego->rs, j, je, ms);
+	  }
+     }
+}
+
 /*************************************************************
   Buffered code
  *************************************************************/
@@ -110,8 +138,15 @@ static void apply_buf(const plan *ego_, R *rio, R *iio)
      BUF_ALLOC(R *, buf, bufsz);
 
      for (i = 0; i < v; ++i, rio += ego->vs, iio += ego->vs) {
-	  for (j = mb; j + batchsz < me; j += batchsz) 
+	  for (j = mb; j + batchsz < me; j += batchsz) {
+	       if (ego->pfdist) {
+		    INT pb = j + ego->pfdist * batchsz;
+		    if (pb < me)
+			 prefetch(ego, rio, iio, pb,
+				  (pb + batchsz < me) ? pb + batchsz : me);
+	       }
 	       dobatch(ego, rio, iio, j, j + batchsz, buf);
+	  }
 
 	  dobatch(ego, rio, iio, j, me, buf);
      }
@@ -144,12 +179,15 @@ static void print(const plan *ego_, printer *p)
      const ct_desc *e = slv->desc;
 
      if (slv->bufferedp)
-	  p->print(p, "(dftw-directbuf/%D-%D/%D%v \"%s\")",
+	  p->print(p, "(dftw-directbuf/%D-%D/%D%v",
 		   compute_batchsize(ego->r), ego->r,
-		   X(twiddle_length)(ego->r, e->tw), ego->v, e->nam);
+		   X(twiddle_length)(ego->r, e->tw), ego->v);
      else
-	  p->print(p, "(dftw-direct-%D/%D%v \"%s\")",
-		   ego->r, X(twiddle_length)(ego->r, e->tw), ego->v, e->nam);
+	  p->print(p, "(dftw-direct-%D/%D%v",
+		   ego->r, X(twiddle_length)(ego->r, e->tw), ego->v);
+     if (ego->pfdist)
+	  p->print(p, "/prefetch-%D", ego->pfdist);
+     p->print(p, " \"%s\")", e->nam);
 }
 
 static int applicable0(const S *ego,
@@ -188,6 +226,16 @@ static int applicable0(const S *ego,
 	  && (e->genus->okp(e, rio + ivs, iio + ivs, irs, ivs,
 			    m, mb, me - *extra_iter, ms, plnr))
 
+	  /* the prefetching loop calls the codelet on blocks */
+	  && (!ego->pfdist
+	      || (1
+		  && *extra_iter == 0
+		  && e->genus->okp(e, rio, iio, irs, ivs, m,
+				   mb, mb + CT_PREFETCH_BLOCK, ms, plnr)
+		  && ((me - mb) % CT_PREFETCH_BLOCK == 0
+		      || e->genus->okp(e, rio, iio, irs, ivs, m, mb,
+				       mb + (me - mb) % CT_PREFETCH_BLOCK,
+				       ms, plnr))))
 	  );
 }
 
@@ -247,6 +295,9 @@ static int applicable(const S *ego,
      if (m * r > 262144 && NO_FIXED_RADIX_LARGE_NP(plnr))
 	  return 0;
 
+     if (!X(ct_prefetch_applicable)(ego->pfdist, r, m, plnr))
+	  return 0;
+
      return 1;
 }
 
@@ -276,7 +327,9 @@ static plan *mkcldw(const ct_solver *ego_,
      if (ego->bufferedp) {
 	  pln = MKPLAN_DFTW(P, &padt, apply_buf);
      } else {
-	  pln = MKPLAN_DFTW(P, &padt, extra_iter ? apply_extra_iter : apply);
+	  pln = MKPLAN_DFTW(P, &padt, 
+			    extra_iter ? apply_extra_iter :
+			    ego->pfdist ? apply_pf : apply);
      }
 
      pln->k = ego->k;
@@ -292,6 +345,9 @@ static plan *mkcldw(const ct_solver *ego_,
      pln->slv = ego;
      pln->brs = X(mkstride)(r, 2 * compute_batchsize(r));
      pln->extra_iter = extra_iter;
+     pln->pfdist = ego->pfdist;
+     pln->ntwiddle = X(twiddle_length)(r, e->tw);
+     pln->twvl = X(twiddle_vl)(e->tw);
 
      X(ops_zero)(&pln->super.super.ops);
      X(ops_madd2)(v * (mcount/e->genus->vl), &e->ops, &pln->super.super.ops);
@@ -301,18 +357,24 @@ static plan *mkcldw(const ct_solver *ego_,
 	  pln->super.super.ops.other += 8 * r * mcount * v;
      }
 
+     if (ego->pfdist) {
+	  /* one prefetch per row and block, roughly */
+	  pln->super.super.ops.other += r * v * (mcount / 8 + 1);
+     }
+
      pln->super.super.could_prune_now_p =
 	  (!ego->bufferedp && r >= 5 && r < 64 && m >= r);
      return &(pln->super.super);
 }
 
 static void regone(planner *plnr, kdftw codelet,
-		   const ct_desc *desc, int dec, int bufferedp)
+		   const ct_desc *desc, int dec, int bufferedp, INT pfdist)
 {
      S *slv = (S *)X(mksolver_ct)(sizeof(S), desc->radix, dec, mkcldw, 0);
      slv->k = codelet;
      slv->desc = desc;
      slv->bufferedp = bufferedp;
+     slv->pfdist = pfdist;
      REGISTER_SOLVER(plnr, &(slv->super.super));
      if (X(mksolver_ct_hook)) {
 	  slv = (S *)X(mksolver_ct_hook)(sizeof(S), desc->radix,
@@ -320,6 +382,7 @@ static void regone(planner *plnr, kdftw codelet,
 	  slv->k = codelet;
 	  slv->desc = desc;
 	  slv->bufferedp = bufferedp;
+	  slv->pfdist = pfdist;
 	  REGISTER_SOLVER(plnr, &(slv->super.super));
      }
 }
@@ -327,6 +390,8 @@ static void regone(planner *plnr, kdftw codelet,
 void X(regsolver_ct_directw)(planner *plnr, kdftw codelet,
 			     const ct_desc *desc, int dec)
 {
-     regone(plnr, codelet, desc, dec, /* bufferedp */ 0);
-     regone(plnr, codelet, desc, dec, /* bufferedp */ 1);
+     regone(plnr, codelet, desc, dec, /* bufferedp */ 0, 0);
+     regone(plnr, codelet, desc, dec, /* bufferedp */ 1, 0);
+     regone(plnr, codelet, desc, dec, /* bufferedp */ 0, CT_PREFETCH_DIST);
+     regone(plnr, codelet, desc, dec, /* bufferedp */ 1, CT_PREFETCH_DIST);
 }
@@ -24,6 +24,7 @@
 typedef struct {
      ct_solver super;
      const ct_desc *desc;
+     INT pfdist;
      kdftwsq k;
 } S;
 
@@ -33,6 +34,7 @@ typedef struct {
      INT r;
      stride rs, vs;
      INT m, ms, v, mb, me;
+     INT pfdist, ntwiddle, twvl;
      twid *td;
      const S *slv;
 } P;
@@ -46,6 +48,28 @@ static void apply(const plan *ego_, R *rio, R *iio)
 	    mb, ego->me, ms);
 }
 
+/* the m loop in blocks, prefetching the block PFDIST blocks ahead */
+static void apply_pf(const plan *ego_, R *rio, R *iio)
+{
+     const P *ego = (const P *) ego_;
+     INT j, l, v = ego->v, vs = WS(ego->vs, 1), rs = WS(ego->rs, 1);
+     INT mb = ego->mb, me = ego->me, ms = ego->ms;
+     INT blk = CT_PREFETCH_BLOCK, d = ego->pfdist * CT_PREFETCH_BLOCK;
+
+     for (j = mb; j < me; j += blk) {
+	  INT je = (j + blk < me) ? j + blk : me;
+	  if (j + d < me) {
+	       INT pe = (j + d + blk < me) ? j + d + blk : me;
+	       for (l = 0; l < v; ++l)
+		    X(ct_prefetch)(rio + l * vs, iio + l * vs, ego->r, rs,
+				   j + d, pe, ms, ego->td->W,
+				   l ? 0 : ego->ntwiddle, ego->twvl);
+	  }
+	  ego->k(rio + j*ms, iio + j*ms, ego->td->W, ego->rs, ego->vs,
+		 j, je, ms);
+     }
+}
+
 static void awake(plan *ego_, enum wakefulness wakefulness)
 {
      P *ego = (P *) ego_;
@@ -67,8 +91,11 @@ static void print(const plan *ego_, printer *p)
      const S *slv = ego->slv;
      const ct_desc *e = slv->desc;
 
-     p->print(p, "(dftw-directsq-%D/%D%v \"%s\")",
-	      ego->r, X(twiddle_length)(ego->r, e->tw), ego->v, e->nam);
+     p->print(p, "(dftw-directsq-%D/%D%v",
+	      ego->r, X(twiddle_length)(ego->r, e->tw), ego->v);
+     if (ego->pfdist)
+	  p->print(p, "/prefetch-%D", ego->pfdist);
+     p->print(p, " \"%s\")", e->nam);
 }
 
 static int applicable(const S *ego,
@@ -94,6 +121,17 @@ static int applicable(const S *ego,
 	  /* check for alignment/vector length restrictions */
 	  && e->genus->okp(e, rio, iio, irs, ivs, m, mb, me, ms, plnr)
 
+	  /* the prefetching loop calls the codelet on blocks */
+	  && (!ego->pfdist
+	      || (1
+		  && e->genus->okp(e, rio, iio, irs, ivs, m,
+				   mb, mb + CT_PREFETCH_BLOCK, ms, plnr)
+		  && ((me - mb) % CT_PREFETCH_BLOCK == 0
+		      || e->genus->okp(e, rio, iio, irs, ivs, m, mb,
+				       mb + (me - mb) % CT_PREFETCH_BLOCK,
+				       ms, plnr))))
+
+	  && X(ct_prefetch_applicable)(ego->pfdist, r, m, plnr)
 	  );
 }
 
@@ -119,7 +157,7 @@ static plan *mkcldw(const ct_solver *ego_,
 		     rio, iio, plnr))
           return (plan *)0;
 
-     pln = MKPLAN_DFTW(P, &padt, apply);
+     pln = MKPLAN_DFTW(P, &padt, ego->pfdist ? apply_pf : apply);
 
      pln->k = ego->k;
      pln->rs = X(mkstride)(r, irs);
@@ -132,25 +170,35 @@ static plan *mkcldw(const ct_solver *ego_,
      pln->mb = mstart;
      pln->me = mstart + mcount;
      pln->slv = ego;
+     pln->pfdist = ego->pfdist;
+     pln->ntwiddle = X(twiddle_length)(r, e->tw);
+     pln->twvl = X(twiddle_vl)(e->tw);
 
      X(ops_zero)(&pln->super.super.ops);
      X(ops_madd2)(mcount/e->genus->vl, &e->ops, &pln->super.super.ops);
 
+     if (ego->pfdist) {
+	  /* one prefetch per row and block, roughly */
+	  pln->super.super.ops.other += r * v * (mcount / 8 + 1);
+     }
+
      return &(pln->super.super);
 }
 
 static void regone(planner *plnr, kdftwsq codelet,
-		   const ct_desc *desc, int dec)
+		   const ct_desc *desc, int dec, INT pfdist)
 {
      S *slv = (S *)X(mksolver_ct)(sizeof(S), desc->radix, dec, mkcldw, 0);
      slv->k = codelet;
      slv->desc = desc;
+     slv->pfdist = pfdist;
      REGISTER_SOLVER(plnr, &(slv->super.super));
      if (X(mksolver_ct_hook)) {
 	  slv = (S *)X(mksolver_ct_hook)(sizeof(S), desc->radix, dec,
 					 mkcldw, 0);
 	  slv->k = codelet;
 	  slv->desc = desc;
+	  slv->pfdist = pfdist;
 	  REGISTER_SOLVER(plnr, &(slv->super.super));
      }
 }
@@ -158,5 +206,6 @@ static void regone(planner *plnr, kdftwsq codelet,
 void X(regsolver_ct_directwsq)(planner *plnr, kdftwsq codelet,
 			       const ct_desc *desc, int dec)
 {
-     regone(plnr, codelet, desc, dec+TRANSPOSE);
+     regone(plnr, codelet, desc, dec+TRANSPOSE, 0);
+     regone(plnr, codelet, desc, dec+TRANSPOSE, CT_PREFETCH_DIST);
 }
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/* Like generic.c, but for a batch of transforms (vector rank 1).  The
+   twiddle table, which is shared with generic.c and with other plans
+   of the same size, is loaded once per VBATCH transforms, and the
+   innermost loops run over the batch with constant bounds, which the
+   compiler can vectorize.  This is meant for prime sizes that have no
+   hard-coded codelet, e.g. 17, 19, 23, ... */
+
+#include "dft.h"
+
+#define VBATCH 8 /* transforms computed together */
+
+typedef struct {
+     solver super;
+} S;
+
+typedef struct {
+     plan_dft super;
+     twid *td;
+     INT n, is, os;
+     INT vl, ivs, ovs;
+} P;
+
+/* hartley() of generic.c for VB transforms.  BUF[q * VBATCH + k] holds
+   the q-th element of transform k.  The dc outputs are stored directly. */
+static void hartley(INT n, INT vb, const R *xr, const R *xi, INT xs, INT vs,
+		    E *buf, R *pr, R *pi, INT ovs)
+{
+     INT i, k;
+
+     for (k = 0; k < vb; ++k) {
+	  const R *ar = xr + k * vs, *ai = xi + k * vs;
+	  E *o = buf + k;
+	  E sr, si;
+
+	  o[0] = sr = ar[0]; o[VBATCH] = si = ai[0]; o += 2 * VBATCH;
+	  for (i = 1; i + i < n; ++i) {
+	       E a = ar[i * xs], b = ar[(n - i) * xs];
+	       E c = ai[i * xs], d = ai[(n - i) * xs];
+	       sr += (o[0] = a + b);
+	       si += (o[VBATCH] = c + d);
+	       o[2 * VBATCH] = a - b;
+	       o[3 * VBATCH] = c - d;
+	       o += 4 * VBATCH;
+	  }
+	  pr[k * ovs] = sr;
+	  pi[k * ovs] = si;
+     }
+
+     /* unused columns enter the accumulation in cdot(); keep them
+	finite */
+     for (; k < VBATCH; ++k)
+	  for (i = 0; i < 2 * n; ++i)
+	       buf[i * VBATCH + k] = 0;
+}
+
+/* cdot() of generic.c for VB transforms.  The accumulation runs over
+   all VBATCH columns of BUF, whatever VB, so that the loops have
+   constant bounds. */
+static void cdot(INT n, INT vb, const E *x, const R *w, INT vs,
+		 R *or0, R *oi0, R *or1, R *oi1)
+{
+     INT i, k;
+     E rr[VBATCH], ri[VBATCH], ir[VBATCH], ii[VBATCH];
+
+     for (k = 0; k < VBATCH; ++k) {
+	  rr[k] = x[k]; ri[k] = 0;
+	  ir[k] = x[VBATCH + k]; ii[k] = 0;
+     }
+     x += 2 * VBATCH;
+     for (i = 1; i + i < n; ++i) {
+	  E wr = w[0], wi = w[1];
+	  for (k = 0; k < VBATCH; ++k) {
+	       rr[k] += x[k] * wr;
+	       ir[k] += x[VBATCH + k] * wr;
+	       ri[k] += x[2 * VBATCH + k] * wi;
+	       ii[k] += x[3 * VBATCH + k] * wi;
+	  }
+	  x += 4 * VBATCH; w += 2;
+     }
+     for (k = 0; k < vb; ++k) {
+	  or0[k * vs] = rr[k] + ii[k];
+	  oi0[k * vs] = ir[k] - ri[k];
+	  or1[k * vs] = rr[k] - ii[k];
+	  oi1[k * vs] = ir[k] + ri[k];
+     }
+}
+
+static void apply(const plan *ego_, R *ri, R *ii, R *ro, R *io)
+{
+     const P *ego = (const P *) ego_;
+     INT i, v, vb;
+     INT n = ego->n, is = ego->is, os = ego->os;
+     INT vl = ego->vl, ivs = ego->ivs, ovs = ego->ovs;
+     E *buf;
+     size_t bufsz = n * 2 * VBATCH * sizeof(E);
+
+     BUF_ALLOC(E *, buf, bufsz);
+
+     for (v = 0; v < vl; v += vb) {
+	  const R *W = ego->td->W;
+
+	  vb = X(imin)(VBATCH, vl - v);
+	  hartley(n, vb, ri + v * ivs, ii + v * ivs, is, ivs, buf,
+		  ro + v * ovs, io + v * ovs, ovs);
+
+	  for (i = 1; i + i < n; ++i) {
+	       cdot(n, vb, buf, W, ovs,
+		    ro + v * ovs + i * os, io + v * ovs + i * os,
+		    ro + v * ovs + (n - i) * os, io + v * ovs + (n - i) * os);
+	       W += n - 1;
+	  }
+     }
+
+     BUF_FREE(buf, bufsz);
+}
+
+static void awake(plan *ego_, enum wakefulness wakefulness)
+{
+     P *ego = (P *) ego_;
+     static const tw_instr half_tw[] = {
+	  { TW_HALF, 1, 0 },
+	  { TW_NEXT, 1, 0 }
+     };
+
+     X(twiddle_awake)(wakefulness, &ego->td, half_tw, ego->n, ego->n,
+		      (ego->n - 1) / 2);
+}
+
+static void print(const plan *ego_, printer *p)
+{
+     const P *ego = (const P *) ego_;
+
+     p->print(p, "(dft-generic-batch-%D-x%D)", ego->n, ego->vl);
+}
+
+static int applicable(const solver *ego, const problem *p_, 
+		      const planner *plnr)
+{
+     const problem_dft *p = (const problem_dft *) p_;
+     UNUSED(ego);
+
+     return (1
+	     && p->sz->rnk == 1
+	     && p->vecsz->rnk == 1
+	     && (p->sz->dims[0].n % 2) == 1 
+	     && CIMPLIES(NO_LARGE_GENERICP(plnr), p->sz->dims[0].n < GENERIC_MIN_BAD)
+	     && CIMPLIES(NO_SLOWP(plnr), p->sz->dims[0].n > GENERIC_MAX_SLOW)
+	     && X(is_prime)(p->sz->dims[0].n)
+
+	     /* transforms are read and written in batch order, so
+		in-place transforms must not move data between them */
+	     && (p->ri != p->ro
+		 || X(tensor_inplace_strides2)(p->sz, p->vecsz))
+	  );
+}
+
+static plan *mkplan(const solver *ego, const problem *p_, planner *plnr)
+{
+     const problem_dft *p;
+     P *pln;
+     INT n, vl;
+
+     static const plan_adt padt = {
+	  X(dft_solve), awake, print, X(plan_null_destroy)
+     };
+
+     if (!applicable(ego, p_, plnr))
+          return (plan *)0;
+
+     pln = MKPLAN_DFT(P, &padt, apply);
+
+     p = (const problem_dft *) p_;
+     pln->n = n = p->sz->dims[0].n;
+     pln->is = p->sz->dims[0].is;
+     pln->os = p->sz->dims[0].os;
+     pln->vl = vl = p->vecsz->dims[0].n;
+     pln->ivs = p->vecsz->dims[0].is;
+     pln->ovs = p->vecsz->dims[0].os;
+     pln->td = 0;
+
+     pln->super.super.ops.add = vl * (n-1) * 5;
+     pln->super.super.ops.mul = 0;
+     pln->super.super.ops.fma = vl * (n-1) * (n-1) ;
+
+     return &(pln->super.super);
+}
+
+static solver *mksolver(void)
+{
+     static const solver_adt sadt = { PROBLEM_DFT, mkplan, 0 };
+     S *slv = MKSOLVER(S, &sadt);
+     return &(slv->super);
+}
+
+void X(dft_generic_batch_register)(planner *p)
+{
+     REGISTER_SOLVER(p, mksolver());
+}
@@ -44,6 +44,23 @@ static void hash(const problem *p_, md5 *m)
      X(tensor_md5)(m, p->vecsz);
 }
 
+/* like hash(), but strides are only hashed up to their layout class,
+   so that e.g. padded variants of the same transform hash equally */
+static void hash_layout(const problem *p_, md5 *m)
+{
+     const problem_dft *p = (const problem_dft *) p_;
+     X(md5puts)(m, "dft-layout");
+     X(md5int)(m, p->ri == p->ro);
+     X(md5INT)(m, p->ii - p->ri);
+     X(md5INT)(m, p->io - p->ro);
+     X(md5int)(m, X(alignment_of)(p->ri));
+     X(md5int)(m, X(alignment_of)(p->ii));
+     X(md5int)(m, X(alignment_of)(p->ro));
+     X(md5int)(m, X(alignment_of)(p->io));
+     X(tensor_md5_layout)(m, p->sz);
+     X(tensor_md5_layout)(m, p->vecsz);
+}
+
 static void print(const problem *ego_, printer *p)
 {
      const problem_dft *ego = (const problem_dft *) ego_;
@@ -69,6 +86,7 @@ static const problem_adt padt =
 {
      PROBLEM_DFT,
      hash,
+     hash_layout,
      zero,
      print,
      destroy
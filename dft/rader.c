@@ -42,22 +42,23 @@ typedef struct {
 
 static rader_tl *omegas = 0;
 
-static R *mkomega(enum wakefulness wakefulness, plan *p_, INT n, INT ginv)
+typedef struct {
+     enum wakefulness wakefulness;
+     plan *p;
+     INT n, ginv;
+} omega_closure;
+
+static void fill_omega(R *omega, void *data)
 {
-     plan_dft *p = (plan_dft *) p_;
-     R *omega;
-     INT i, gpower;
+     const omega_closure *c = (const omega_closure *) data;
+     plan_dft *p = (plan_dft *) c->p;
+     INT i, gpower, n = c->n, ginv = c->ginv;
      trigreal scale;
      triggen *t;
 
-     if ((omega = X(rader_tl_find)(n, n, ginv, omegas)))
-	  return omega;
-
-     omega = (R *)MALLOC(sizeof(R) * (n - 1) * 2, TWIDDLES);
-
      scale = n - 1.0; /* normalization for convolution */
 
-     t = X(mktriggen)(wakefulness, n);
+     t = X(mktriggen)(c->wakefulness, n);
      for (i = 0, gpower = 1; i < n-1; ++i, gpower = MULMOD(gpower, ginv, n)) {
 	  trigreal w[2];
 	  t->cexpl(t, gpower, w);
@@ -67,7 +68,29 @@ static R *mkomega(enum wakefulness wakefulness, plan *p_, INT n, INT ginv)
      X(triggen_destroy)(t);
      A(gpower == 1);
 
-     p->apply(p_, omega, omega + 1, omega, omega + 1);
+     p->apply(c->p, omega, omega + 1, omega, omega + 1);
+}
+
+static R *mkomega(enum wakefulness wakefulness, plan *p_, INT n, INT ginv)
+{
+     R *omega;
+     omega_closure c;
+     md5 key;
+
+     if ((omega = X(rader_tl_find)(n, n, ginv, omegas)))
+	  return omega;
+
+     c.wakefulness = wakefulness;
+     c.p = p_;
+     c.n = n;
+     c.ginv = ginv;
+
+     X(md5begin)(&key);
+     X(md5puts)(&key, "dft-rader");
+     X(md5int)(&key, (int) wakefulness);
+     X(md5INT)(&key, n);
+     X(md5INT)(&key, ginv);
+     omega = X(shmtab_mk)(&key, (n - 1) * 2, fill_omega, &c);
 
      X(rader_tl_insert)(n, n, ginv, omega, &omegas);
      return omega;
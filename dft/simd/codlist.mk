@@ -74,6 +74,22 @@ Q1F = q1fv_2.c q1fv_4.c q1fv_5.c q1fv_8.c
 # as above, but FFTW_BACKWARD
 Q1B = q1bv_2.c q1bv_4.c q1bv_5.c q1bv_8.c
 
+###########################################################################
+# Variants of some of the codelets above, generated with different
+# genfft options and registered as separate solvers, so that the planner
+# can pick the fastest variant on each machine:
+#    <codelet>_rs: register-aware schedule (genfft -registers 16)
+#    <codelet>_ls: loads and stores of the same complex number grouped
+#    <codelet>_f:  FMA-contracted expressions, even if !HAVE_FMA
+VARIANTS = n1fv_32_rs.c n1fv_32_ls.c n1fv_32_f.c n1fv_64_rs.c		\
+n1fv_64_ls.c n1fv_64_f.c n1bv_32_rs.c n1bv_32_ls.c n1bv_32_f.c		\
+n1bv_64_rs.c n1bv_64_ls.c n1bv_64_f.c t1fv_16_rs.c t1fv_16_ls.c		\
+t1fv_16_f.c t1fv_32_rs.c t1fv_32_ls.c t1fv_32_f.c t1fv_64_rs.c		\
+t1fv_64_ls.c t1fv_64_f.c t1bv_16_rs.c t1bv_16_ls.c t1bv_16_f.c		\
+t1bv_32_rs.c t1bv_32_ls.c t1bv_32_f.c t1bv_64_rs.c t1bv_64_ls.c		\
+t1bv_64_f.c
+
 ###########################################################################
 SIMD_CODELETS = $(N1F) $(N1B) $(N2F) $(N2B) $(N2S) $(T1FU) $(T1F)	\
-$(T2F) $(T3F) $(T1BU) $(T1B) $(T2B) $(T3B) $(T1S) $(T2S) $(Q1F) $(Q1B)
+$(T2F) $(T3F) $(T1BU) $(T1B) $(T2B) $(T3B) $(T1S) $(T2S) $(Q1F) $(Q1B)	\
+$(VARIANTS)
@@ -60,6 +60,7 @@ let standalone = ref false
 let pipeline_latency = ref 0
 let schedule_for_pipeline = ref false
 let generate_bytw = ref true
+let target_registers = ref 0
 
 (* command-line parser for magic parameters *)
 let undocumented = " Undocumented voodoo parameter"
@@ -101,6 +102,8 @@ let speclist = [
   "-schedule-type", set_int schedule_type, undocumented;
   "-pipeline-latency", set_int pipeline_latency, undocumented;
   "-schedule-for-pipeline", set_bool schedule_for_pipeline, undocumented;
+  "-registers", set_int target_registers,
+  "<n> : Schedule blocks that fit in <n> registers to minimize live ranges";
 
   "-dif-split-radix", set_bool dif_split_radix, undocumented;
   "-dit-split-radix", unset_bool dif_split_radix, undocumented;
@@ -172,13 +172,103 @@ let rec sequentially = function
     [] -> Done
   | a :: b -> Seq (Instr a, sequentially b)
 
+(*
+   Register-aware scheduling of small blocks.
+
+   The cache-oblivious schedule above recursively partitions the dag
+   regardless of the number of registers of the target machine.
+   When -registers <n> is given, a block whose values fit into n
+   registers is instead ordered sequentially in Sethi-Ullman order,
+   i.e., the predecessor needing the most registers is evaluated
+   first, which minimizes the number of simultaneously live values.
+   Blocks that do not fit are partitioned as usual.
+*)
+
+(* Sethi-Ullman number of each node: the number of registers needed to
+   evaluate the node (exactly for trees, approximately for dags) *)
+let su_number dag =
+  let rec need node =
+    if node.label >= 0 then node.label
+    else
+      let l = List.sort (fun a b -> compare b a)
+	  (List.map need node.predecessors) in
+      let (n, _) = List.fold_left
+	  (fun (m, i) x -> (max m (x + i), i + 1)) (1, 0) l in
+      begin
+	node.label <- n;
+	n
+      end
+  in begin
+    Dag.for_all dag (fun node -> node.label <- (-1));
+    Dag.for_all dag (fun node -> let _ = need node in ());
+  end
+
+(* order the nodes by depth-first search from the outputs, visiting
+   the most register-hungry predecessors first *)
+let su_order outputs =
+  let by_need l = List.sort (fun a b -> compare b.label a.label) l in
+  let rec visit acc node =
+    if has_color RED node then acc
+    else begin
+      set_color RED node;
+      node :: (List.fold_left visit acc (by_need node.predecessors))
+    end
+  in List.rev (List.fold_left visit [] (by_need outputs))
+
+(* dag nodes, by identity *)
+module NodeTbl = Hashtbl.Make (struct
+  type t = dagnode
+  let equal = (==)
+  let hash n = Variable.hash n.assigned
+end)
+
+(* maximum number of values live at any point of ORDER *)
+let max_live order =
+  let uses = NodeTbl.create (List.length order) in
+  let () = List.iter
+      (fun n -> NodeTbl.replace uses n (ref (List.length n.successors)))
+      order in
+  let rec loop live peak = function
+    | [] -> peak
+    | n :: rest ->
+	let live = if Util.null n.successors then live else live + 1 in
+	let peak = max live peak in
+	let dead = List.filter
+	    (fun p ->
+	      try
+		let r = NodeTbl.find uses p in
+		begin decr r; !r = 0 end
+	      with Not_found -> false)
+	    n.predecessors in
+	loop (live - List.length dead) peak rest
+  in loop 0 0 order
+
+let schedule_in_registers alist =
+  if !Magic.target_registers <= 0 then
+    None
+  else
+    let dag = makedag alist in
+    let dag' = Dag.to_list dag in
+    let outputs = List.filter (fun node -> Util.null node.successors) dag' in
+    begin
+      su_number dag;
+      Dag.for_all dag (set_color BLACK);
+      let order = su_order outputs in
+      if max_live order <= !Magic.target_registers then
+	Some (sequentially (List.map to_assignment order))
+      else
+	None
+    end
+
 let schedule =
   let rec schedule_alist = function
     | [] -> Done
     | [a] -> Instr a
-    | alist -> match connected_components alist with
-	| ([a]) -> schedule_connected a
-	| l -> Par (List.map schedule_alist l)
+    | alist -> match schedule_in_registers alist with
+      | Some s -> s
+      | None -> match connected_components alist with
+	  | ([a]) -> schedule_connected a
+	  | l -> Par (List.map schedule_alist l)
 
   and schedule_connected alist = 
     match partition alist with
@@ -277,7 +277,10 @@ void *X(malloc_plain)(size_t n)
 
 void X(ifree)(void *p)
 {
-     X(kernel_free)(p);
+     if (IN_ARENA(p))
+	  X(arena_free)(p);
+     else
+	  X(kernel_free)(p);
 }
 
 #endif
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Plan arenas.
+
+   While an arena is current, MALLOC of plans, strides and twiddle
+   factors bumps a pointer in the arena instead of calling malloc, so
+   that the nodes of the final plan and its tables are packed in the
+   order in which they are created and awakened, which is roughly the
+   order in which they are executed, each aligned to a cache line.
+
+   Blocks are "freed" one by one as usual, which only decrements the
+   count of live blocks; the arena goes away with its last block.
+   Thus a twiddle table that another plan borrowed (see twiddle.c)
+   keeps the arena alive.
+
+   All arenas are carved out of one region of address space reserved
+   once, so that X(ifree) can tell an arena block from a malloc'ed one
+   with a range check.  The region is reserved inaccessible, which
+   commits no memory even under strict overcommit accounting, and each
+   chunk is made accessible when an arena takes it.  Blocks that do not
+   fit in what is left of the region, or whose chunk cannot be
+   committed, come from malloc.  The region is unmapped by
+   X(arena_cleanup), or when arenas are turned off, once no arena is
+   alive. */
+
+#include "ifftw.h"
+
+arena *X(arena_current) = 0;
+char *X(arena_lo) = 0, *X(arena_hi) = 0;
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H) && \
+    !defined(FFTW_DEBUG_MALLOC)
+#  define ARENAS 1
+#  include <sys/mman.h>
+#  ifdef HAVE_UNISTD_H
+#    include <unistd.h>
+#  endif
+#endif
+
+#ifdef ARENAS
+
+#ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+#endif
+
+#define LINE 64
+#define HUGEPAGE ((size_t) 2 << 20)
+#define MINCHUNK ((size_t) 64 << 10)
+#define ROUNDUP(n, a) ((((n) + (a) - 1) / (a)) * (a))
+
+/* address space reserved for arenas; pages are only committed when
+   an arena takes them, and returned to the system when it goes away */
+#define REGION ((size_t) (sizeof(void *) >= 8 ? 16 : 1) << 28)
+
+typedef struct span_s {
+     char *lo;
+     size_t len;
+     struct span_s *cdr;
+} span;
+
+struct arena_s {
+     span *chunks;		/* most recent first */
+     char *next;		/* bump pointer into chunks->lo */
+     INT live;			/* blocks not yet freed */
+     unsigned flags;
+     struct arena_s *cdr;
+};
+
+static char *base = 0;		/* the mapping that holds the region */
+static span *freelist = 0;	/* free spans of the region, by address */
+static arena *arenas = 0;	/* arenas with live blocks */
+static unsigned arena_flags = 0;
+static size_t pagesz = 0;
+
+/* Chunks are whole pages, so that madvise() and munlock() of a chunk
+   never touch a page that another arena is using. */
+static size_t page_size(void)
+{
+     if (!pagesz) {
+#if defined(HAVE_UNISTD_H) && defined(_SC_PAGESIZE)
+	  long p = sysconf(_SC_PAGESIZE);
+	  pagesz = p > 0 ? (size_t) p : 4096;
+#else
+	  pagesz = 4096;
+#endif
+     }
+     return pagesz;
+}
+
+static int reserve(void)
+{
+     void *p;
+
+     if (X(arena_lo))
+	  return 1;
+
+     /* one extra huge page to align the region */
+     p = mmap(0, REGION + HUGEPAGE, PROT_NONE,
+	      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+     if (p == MAP_FAILED)
+	  return 0;
+
+     base = (char *) p;
+     freelist = (span *) MALLOC(sizeof(span), OTHER);
+     freelist->lo = (char *) ROUNDUP((uintptr_t) p, HUGEPAGE);
+     freelist->len = REGION;
+     freelist->cdr = 0;
+     X(arena_lo) = freelist->lo;
+     X(arena_hi) = freelist->lo + REGION;
+     return 1;
+}
+
+/* unmap the region if no arena uses it */
+static void release(void)
+{
+     span *s;
+
+     if (!X(arena_lo) || arenas)
+	  return;
+
+     while ((s = freelist)) {
+	  freelist = s->cdr;
+	  X(ifree)(s);
+     }
+     munmap(base, REGION + HUGEPAGE);
+     base = X(arena_lo) = X(arena_hi) = 0;
+}
+
+/* first fit in the free list */
+static char *span_alloc(size_t len)
+{
+     span **sp, *s;
+
+     for (sp = &freelist; (s = *sp); sp = &s->cdr) {
+	  if (s->len >= len) {
+	       char *lo = s->lo;
+	       s->lo += len;
+	       s->len -= len;
+	       if (!s->len) {
+		    *sp = s->cdr;
+		    X(ifree)(s);
+	       }
+	       return lo;
+	  }
+     }
+     return 0;
+}
+
+/* give LEN bytes at LO back to the system and to the free list */
+static void span_free(char *lo, size_t len)
+{
+     span *prev = 0, *s, *t;
+
+#if defined(HAVE_MADVISE) && defined(MADV_DONTNEED)
+     madvise(lo, len, MADV_DONTNEED);
+#endif
+     mprotect(lo, len, PROT_NONE);
+
+     for (s = freelist; s && s->lo < lo; s = s->cdr)
+	  prev = s;
+
+     if (prev && prev->lo + prev->len == lo) {
+	  t = prev;
+	  t->len += len;
+     } else {
+	  t = (span *) MALLOC(sizeof(span), OTHER);
+	  t->lo = lo;
+	  t->len = len;
+	  t->cdr = s;
+	  if (prev)
+	       prev->cdr = t;
+	  else
+	       freelist = t;
+     }
+
+     if (s && t->lo + t->len == s->lo) {
+	  t->len += s->len;
+	  t->cdr = s->cdr;
+	  X(ifree)(s);
+     }
+}
+
+/* a new chunk of at least N bytes, appended to the last chunk if the
+   region has room right after it */
+static int grow(arena *a, size_t n)
+{
+     size_t len = a->chunks ? 2 * a->chunks->len : MINCHUNK;
+     size_t align = (a->flags & ARENA_HUGEPAGE) ? HUGEPAGE : page_size();
+     span *c;
+     char *lo;
+
+     len = ROUNDUP(X(imax)((INT) len, (INT) n), align);
+     if (!(lo = span_alloc(len)))
+	  return 0;
+     if (mprotect(lo, len, PROT_READ | PROT_WRITE)) {
+	  span_free(lo, len);	/* cannot commit it */
+	  return 0;
+     }
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+     if (a->flags & ARENA_HUGEPAGE)
+	  madvise(lo, len, MADV_HUGEPAGE);
+#endif
+#ifdef HAVE_MLOCK
+     if (a->flags & ARENA_LOCK)
+	  mlock(lo, len);
+#endif
+
+     if ((c = a->chunks) && c->lo + c->len == lo) {
+	  c->len += len;
+     } else {
+	  c = (span *) MALLOC(sizeof(span), OTHER);
+	  c->lo = a->next = lo;
+	  c->len = len;
+	  c->cdr = a->chunks;
+	  a->chunks = c;
+     }
+     return 1;
+}
+
+static void arena_destroy(arena *a)
+{
+     arena **ap;
+     span *c;
+
+     for (ap = &arenas; *ap != a; ap = &(*ap)->cdr)
+	  ;
+     *ap = a->cdr;
+
+     while ((c = a->chunks)) {
+	  a->chunks = c->cdr;
+#ifdef HAVE_MLOCK
+	  if (a->flags & ARENA_LOCK)
+	       munlock(c->lo, c->len);
+#endif
+	  span_free(c->lo, c->len);
+	  X(ifree)(c);
+     }
+     X(ifree)(a);
+
+     if (!arena_flags)
+	  release();
+}
+
+int X(arena_set_flags)(unsigned flags)
+{
+     arena_flags = flags;
+     if (!flags) {
+	  release();
+	  return 1;
+     }
+     return reserve();
+}
+
+void X(arena_cleanup)(void)
+{
+     release();
+}
+
+arena *X(arena_begin)(void)
+{
+     arena *a;
+
+     if (!arena_flags || !reserve())
+	  return 0;
+
+     a = (arena *) MALLOC(sizeof(arena), OTHER);
+     a->chunks = 0;
+     a->next = 0;
+     a->live = 0;
+     a->flags = arena_flags;
+     a->cdr = arenas;
+     arenas = a;
+
+     X(arena_current) = a;
+     return a;
+}
+
+void X(arena_end)(arena *a)
+{
+     if (a) {
+	  A(X(arena_current) == a);
+	  X(arena_current) = 0;
+	  if (!a->live)
+	       arena_destroy(a);
+     }
+}
+
+void *X(arena_malloc)(size_t n)
+{
+     arena *a = X(arena_current);
+     span *c;
+     char *p;
+
+     n = ROUNDUP(X(imax)((INT) n, 1), LINE);
+     if (!(c = a->chunks) || a->next + n > c->lo + c->len)
+	  if (!grow(a, n))
+	       return X(malloc_plain)(n);	/* region exhausted */
+
+     p = a->next;
+     a->next += n;
+     ++a->live;
+     return p;
+}
+
+void X(arena_free)(void *p)
+{
+     arena *a;
+     span *c;
+
+     for (a = arenas; a; a = a->cdr)
+	  for (c = a->chunks; c; c = c->cdr)
+	       if ((char *) p >= c->lo && (char *) p < c->lo + c->len) {
+		    if (--a->live == 0 && a != X(arena_current))
+			 arena_destroy(a);
+		    return;
+	       }
+     A(0 /* not an arena block */);
+}
+
+#else /* no arenas */
+
+int X(arena_set_flags)(unsigned flags)
+{
+     return !flags;
+}
+
+arena *X(arena_begin)(void)
+{
+     return 0;
+}
+
+void X(arena_end)(arena *a)
+{
+     UNUSED(a);
+}
+
+void *X(arena_malloc)(size_t n)
+{
+     return MALLOC(n, OTHER);
+}
+
+void X(arena_free)(void *p)
+{
+     UNUSED(p);
+     A(0 /* not an arena block */);
+}
+
+void X(arena_cleanup)(void)
+{
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Out-of-place copy of a rank-RNK array of runs of VL contiguous
+   reals, for any strides.
+
+   The array is split recursively, halving the longest dimension,
+   until a block fits in the cache together with its image.  This
+   works for any permutation of the dimensions without knowing the
+   cache size (beyond the CACHESIZE lower bound), in the same way as
+   X(tile2d) does for two dimensions.  The blocks are then copied by
+   a loop nest in the order of the dimensions, which the caller sorts
+   by decreasing output stride so that the innermost loop writes
+   (nearly) contiguous memory.
+
+   On x86-64, runs whose length is a multiple of 16 bytes are moved
+   with SSE loads and stores.  If NT is set, the stores bypass the
+   cache (non-temporal stores), which avoids reading the output into
+   the cache for an array that is much larger than the cache anyway. */
+
+#include "ifftw.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#  ifdef HAVE_XMMINTRIN_H
+#    include <xmmintrin.h>
+#    define WIDE_TYPE __m128
+#  endif
+#endif
+
+typedef struct {
+     const iodim *d;
+     int rnk;
+     INT vl;
+     INT blocksz;
+     int nt;
+     INT *n;			/* the extents of the current block */
+} args;
+
+#ifdef WIDE_TYPE
+#define WIDESZ ((INT) sizeof(WIDE_TYPE))
+
+/* runs of VL reals are made of whole WIDE_TYPEs */
+static int widep(INT vl)
+{
+     return (vl * (INT) sizeof(R)) % WIDESZ == 0;
+}
+
+/* each of the N runs starts at an address aligned for WIDE_TYPE */
+static int streamp(const R *O, INT n, INT os)
+{
+     return (1
+	     && ((size_t) O) % WIDESZ == 0
+	     && (n == 1 || (os * (INT) sizeof(R)) % WIDESZ == 0));
+}
+
+static void move_wide(R *I, R *O, INT n, INT is, INT os, INT vl)
+{
+     INT i, v, nf = vl * (INT) (sizeof(R) / sizeof(float));
+
+     for (i = 0; i < n; ++i, I += is, O += os) {
+	  const float *ip = (const float *) I;
+	  float *op = (float *) O;
+	  for (v = 0; v < nf; v += 4)
+	       _mm_storeu_ps(op + v, _mm_loadu_ps(ip + v));
+     }
+}
+
+static void move_stream(R *I, R *O, INT n, INT is, INT os, INT vl)
+{
+     INT i, v, nf = vl * (INT) (sizeof(R) / sizeof(float));
+
+     for (i = 0; i < n; ++i, I += is, O += os) {
+	  const float *ip = (const float *) I;
+	  float *op = (float *) O;
+	  for (v = 0; v < nf; v += 4)
+	       _mm_stream_ps(op + v, _mm_loadu_ps(ip + v));
+     }
+}
+#endif
+
+int X(cpynd_widep)(INT vl)
+{
+#ifdef WIDE_TYPE
+     return widep(vl);
+#else
+     UNUSED(vl);
+     return 0;
+#endif
+}
+
+/* N runs, with strides IS and OS */
+static void move(const args *a, R *I, R *O, INT n, INT is, INT os)
+{
+#ifdef WIDE_TYPE
+     if (widep(a->vl)) {
+	  if (a->nt && streamp(O, n, os))
+	       move_stream(I, O, n, is, os, a->vl);
+	  else
+	       move_wide(I, O, n, is, os, a->vl);
+	  return;
+     }
+#endif
+     X(cpy1d)(I, O, n, is, os, a->vl);
+}
+
+static void loops(const args *a, int k, R *I, R *O)
+{
+     const iodim *d = a->d + k;
+     INT i, n = a->n[k];
+
+     if (k == a->rnk - 1)
+	  move(a, I, O, n, d->is, d->os);
+     else
+	  for (i = 0; i < n; ++i, I += d->is, O += d->os)
+	       loops(a, k + 1, I, O);
+}
+
+/* Splitting the innermost loop of a contiguous output further would
+   write runs shorter than MINRUN bytes, which the stores cannot
+   combine into full cache lines.  Non-temporal stores need longer
+   runs, since they go to memory as soon as the processor runs out of
+   write-combining buffers. */
+#define MINRUN (4 * CACHELINE)
+#define MINRUN_NT (64 * CACHELINE)
+
+static int shortrunp(const args *a, int k)
+{
+     const iodim *d = a->d + k;
+     INT minrun = a->nt ? MINRUN_NT : MINRUN;
+     return (1
+	     && k == a->rnk - 1
+	     && X(iabs)(d->os) == a->vl
+	     && a->n[k] * a->vl * (INT) sizeof(R) < 2 * minrun);
+}
+
+/* copy the block of VOL reals at I */
+static void recur(const args *a, INT vol, R *I, R *O)
+{
+     INT *n = a->n;
+     int i, k;
+
+     for (k = -1, i = 0; i < a->rnk; ++i)
+	  if ((k < 0 || n[i] > n[k]) && !shortrunp(a, i))
+	       k = i;
+
+     if (vol <= a->blocksz || k < 0 || n[k] < 2)
+	  loops(a, 0, I, O);
+     else {
+	  INT nk = n[k], h = nk / 2;
+	  vol /= nk;
+	  n[k] = h;
+	  recur(a, vol * h, I, O);
+	  n[k] = nk - h;
+	  recur(a, vol * (nk - h), I + h * a->d[k].is, O + h * a->d[k].os);
+	  n[k] = nk;
+     }
+}
+
+void X(cpynd)(R *I, R *O, int rnk, const iodim *d, INT vl, int nt)
+{
+     args a;
+     INT vol;
+     int i;
+
+     a.d = d;
+     a.rnk = rnk;
+     a.vl = vl;
+     a.blocksz = CACHESIZE / (2 * (INT) sizeof(R));
+     a.nt = nt;
+
+     if (rnk == 0)
+	  move(&a, I, O, 1, 0, 0);
+     else {
+	  STACK_MALLOC(INT *, a.n, rnk * sizeof(INT));
+	  for (vol = vl, i = 0; i < rnk; ++i)
+	       vol *= (a.n[i] = d[i].n);
+	  recur(&a, vol, I, O);
+	  STACK_FREE(a.n);
+     }
+
+#ifdef WIDE_TYPE
+     if (nt)
+	  _mm_sfence(); /* order the non-temporal stores */
+#endif
+}
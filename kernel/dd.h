@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Double-double arithmetic, for FFTW_DDOUBLE.
+
+   A number is the unevaluated sum HI + LO of two doubles with
+   |LO| <= ulp(HI)/2, which carries 106 bits of significand.  The
+   operations are built from the error-free transformations
+
+      two_sum(a, b)  = s + e  with s = fl(a + b),  exactly
+      two_prod(a, b) = p + e  with p = fl(a * b),  exactly
+
+   where the error e of the product is computed with one fma if the
+   hardware has it, and by Dekker's splitting otherwise.  Addition
+   and multiplication have a relative error of a few units in 2^-106
+   (Dekker, Numer. Math. 18, 1971; Hida, Li and Bailey, ARITH-15).
+
+   This file requires a C++ compiler: the operators are overloaded
+   so that the scalar codelets, and the rest of FFTW, compile
+   unchanged with R = dd.  It is also used by libbench2, and hence
+   must not depend on the rest of FFTW. */
+
+#ifndef __DD_H__
+#define __DD_H__
+
+#ifndef __cplusplus
+#  error "double-double precision requires a C++ compiler"
+#endif
+
+/* our includers may be inside extern "C" */
+extern "C++" {
+
+#include <math.h>
+
+struct dd {
+     double hi, lo;
+
+     dd() {}
+     dd(double x) : hi(x), lo(0.0) {}
+     dd(int x) : hi(x), lo(0.0) {}
+     dd(unsigned x) : hi(x), lo(0.0) {}
+     dd(long x) : hi((double) x), lo((double) (x - (long) hi)) {}
+     dd(unsigned long x)
+	  : hi((double) x), lo((double) ((long) (x - (unsigned long) hi))) {}
+     dd(long long x) : hi((double) x), lo((double) (x - (long long) hi)) {}
+     dd(long double x) : hi((double) x), lo((double) (x - hi)) {}
+#if defined(__SIZEOF_FLOAT128__)
+     dd(__float128 x) : hi((double) x), lo((double) (x - hi)) {}
+#endif
+
+     /* no implicit conversions out of dd, lest the mixed expressions
+	of the codelets become ambiguous */
+     explicit operator double() const { return hi; }
+     explicit operator int() const {	/* truncate toward zero */
+	  int i = (int) hi;
+	  if (i == hi && (hi > 0 ? lo < 0 : (hi < 0 && lo > 0)))
+	       i += hi > 0 ? -1 : 1;
+	  return i;
+     }
+};
+
+/* s + e = a + b exactly, assuming |a| >= |b| */
+static inline double dd_quick_two_sum(double a, double b, double *e)
+{
+     double s = a + b;
+     *e = b - (s - a);
+     return s;
+}
+
+/* s + e = a + b exactly */
+static inline double dd_two_sum(double a, double b, double *e)
+{
+     double s = a + b;
+     double bb = s - a;
+     *e = (a - (s - bb)) + (b - bb);
+     return s;
+}
+
+/* p + e = a * b exactly */
+static inline double dd_two_prod(double a, double b, double *e)
+{
+     double p = a * b;
+#if defined(FP_FAST_FMA)
+     *e = fma(a, b, -p);
+#else
+     /* Dekker: split each factor into two halves of 26 bits */
+     const double split = 134217729.0; /* 2^27 + 1 */
+     double t, ah, al, bh, bl;
+     t = split * a; ah = t - (t - a); al = a - ah;
+     t = split * b; bh = t - (t - b); bl = b - bh;
+     *e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+     return p;
+}
+
+static inline dd dd_make(double hi, double lo)
+{
+     dd r;
+     r.hi = hi; r.lo = lo;
+     return r;
+}
+
+static inline dd operator+(dd a, dd b)
+{
+     double s, e, t, f;
+     s = dd_two_sum(a.hi, b.hi, &e);
+     t = dd_two_sum(a.lo, b.lo, &f);
+     e += t;
+     s = dd_quick_two_sum(s, e, &e);
+     e += f;
+     s = dd_quick_two_sum(s, e, &e);
+     return dd_make(s, e);
+}
+
+static inline dd operator-(dd a)
+{
+     return dd_make(-a.hi, -a.lo);
+}
+
+static inline dd operator+(dd a)
+{
+     return a;
+}
+
+static inline dd operator-(dd a, dd b)
+{
+     return a + (-b);
+}
+
+static inline dd operator*(dd a, dd b)
+{
+     double p, e;
+     p = dd_two_prod(a.hi, b.hi, &e);
+     e += a.hi * b.lo + a.lo * b.hi;
+     p = dd_quick_two_sum(p, e, &e);
+     return dd_make(p, e);
+}
+
+/* long division: three quotient digits */
+static inline dd operator/(dd a, dd b)
+{
+     double q1, q2, q3;
+     dd r;
+     q1 = a.hi / b.hi;
+     r = a - b * dd(q1);
+     q2 = r.hi / b.hi;
+     r = r - b * dd(q2);
+     q3 = r.hi / b.hi;
+     q1 = dd_quick_two_sum(q1, q2, &q2);
+     return dd_make(q1, q2) + dd(q3);
+}
+
+static inline dd &operator+=(dd &a, dd b) { return a = a + b; }
+static inline dd &operator-=(dd &a, dd b) { return a = a - b; }
+static inline dd &operator*=(dd &a, dd b) { return a = a * b; }
+static inline dd &operator/=(dd &a, dd b) { return a = a / b; }
+
+static inline bool operator==(dd a, dd b)
+{
+     return a.hi == b.hi && a.lo == b.lo;
+}
+
+static inline bool operator!=(dd a, dd b) { return !(a == b); }
+
+static inline bool operator<(dd a, dd b)
+{
+     return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+static inline bool operator>(dd a, dd b) { return b < a; }
+static inline bool operator<=(dd a, dd b) { return !(b < a); }
+static inline bool operator>=(dd a, dd b) { return !(a < b); }
+
+static inline dd fabs(dd a)
+{
+     return a.hi < 0.0 ? -a : a;
+}
+
+/* one Newton step from the double square root */
+static inline dd sqrt(dd a)
+{
+     double x, p, e;
+     if (a.hi <= 0.0)
+	  return dd(sqrt(a.hi));
+     x = sqrt(a.hi);
+     p = dd_two_prod(x, x, &e);
+     return dd(x) + (a - dd_make(p, e)) * dd(0.5 / x);
+}
+
+} /* extern "C++" */
+
+#endif /* __DD_H__ */
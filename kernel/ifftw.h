@@ -41,6 +41,11 @@
 # include <inttypes.h>           /* uintptr_t, maybe */
 #endif
 
+#ifdef FFTW_DDOUBLE
+# include <float.h>
+# include "dd.h"                 /* double-double arithmetic */
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -71,6 +76,17 @@ extern "C"
   typedef __float128 R;
 # define X(name) CONCAT(fftwq_, name)
 # define TRIGREAL_IS_QUAD
+#elif defined(FFTW_DDOUBLE)
+  typedef dd R;
+# define X(name) CONCAT(fftwdd_, name)
+  /* twiddle factors need at least the 106 bits of a double-double */
+# if defined(HAVE_LIBQUADMATH)
+#  define TRIGREAL_IS_QUAD
+# elif LDBL_MANT_DIG >= 106
+#  define TRIGREAL_IS_LONG_DOUBLE
+# else
+#  error "double-double precision requires libquadmath or a 106-bit long double"
+# endif
 #else
   typedef double R;
 # define X(name) CONCAT(fftw_, name)
@@ -275,6 +291,25 @@ enum malloc_tag {
 IFFTW_EXTERN void X(ifree)(void *ptr);
 extern void X(ifree0)(void *ptr);
 
+/* arena.c: plans, strides and twiddles of the final plan are
+   allocated in an arena while one is current */
+typedef struct arena_s arena;
+enum { ARENA_ON = 1, ARENA_LOCK = 2, ARENA_HUGEPAGE = 4 };
+
+IFFTW_EXTERN arena *X(arena_current);
+IFFTW_EXTERN char *X(arena_lo), *X(arena_hi);
+int X(arena_set_flags)(unsigned flags);
+arena *X(arena_begin)(void);
+void X(arena_end)(arena *a);
+IFFTW_EXTERN void *X(arena_malloc)(size_t n);
+void X(arena_free)(void *p);
+void X(arena_cleanup)(void);
+
+#define ARENA_TAG(what) \
+     ((what) == PLANS || (what) == TWIDDLES || (what) == STRIDES)
+#define IN_ARENA(p) \
+     ((char *) (p) >= X(arena_lo) && (char *) (p) < X(arena_hi))
+
 #ifdef FFTW_DEBUG_MALLOC
 
 IFFTW_EXTERN void *X(malloc_debug)(size_t n, enum malloc_tag what,
@@ -285,7 +320,9 @@ IFFTW_EXTERN void X(malloc_print_minfo)(int vrbose);
 #else /* ! FFTW_DEBUG_MALLOC */
 
 IFFTW_EXTERN void *X(malloc_plain)(size_t sz);
-#define MALLOC(n, what)  X(malloc_plain)(n)
+#define MALLOC(n, what)						\
+     ((ARENA_TAG(what) && X(arena_current)) ?			\
+      X(arena_malloc)(n) : X(malloc_plain)(n))
 
 #endif
 
@@ -334,6 +371,7 @@ extern int X(in_thread);
 crude_time X(get_crude_time)(void);
 double X(elapsed_since)(const planner *plnr, const problem *p,
 			crude_time t0); /* time in seconds since t0 */
+double X(crude_elapsed)(crude_time t0); /* ditto, without the cost hook */
 
 /*-----------------------------------------------------------------------*/
 /* ops.c: */
@@ -457,6 +495,7 @@ tensor *X(mktensor_5d)(INT n0, INT is0, INT os0,
 		       INT n4, INT is4, INT os4);
 INT X(tensor_sz)(const tensor *sz);
 void X(tensor_md5)(md5 *p, const tensor *t);
+void X(tensor_md5_layout)(md5 *p, const tensor *t);
 INT X(tensor_max_index)(const tensor *sz);
 INT X(tensor_min_istride)(const tensor *sz);
 INT X(tensor_min_ostride)(const tensor *sz);
@@ -506,6 +545,7 @@ enum {
 typedef struct {
      int problem_kind;
      void (*hash) (const problem *ego, md5 *p);
+     void (*hash_layout) (const problem *ego, md5 *p); /* may be 0 */
      void (*zero) (const problem *ego);
      void (*print) (const problem *ego, printer *p);
      void (*destroy) (problem *ego);
@@ -607,6 +647,10 @@ typedef struct slvdesc_s {
      unsigned nam_hash;
      int reg_id;
      int next_for_same_problem_kind;
+
+     /* search statistics */
+     int ninvoke, nplan, nmeasure, nwin;
+     double tmeasure; /* seconds spent measuring plans */
 } slvdesc;
 
 typedef struct solution_s solution; /* opaque */
@@ -734,6 +778,15 @@ typedef struct {
 
 typedef enum { COST_SUM, COST_MAX } cost_kind;
 
+/* planning statistics for one problem kind */
+typedef struct {
+     int nprob;          /* problems (and subproblems) planned */
+     int hit, miss;      /* wisdom lookups */
+     int nsearch;        /* problems not answered by wisdom */
+     int nrelax;         /* searches that succeeded only with relaxed flags */
+     int ntimeout;       /* searches abandoned because of the time limit */
+} kindstat;
+
 struct planner_s {
      const planner_adt *adt;
      void (*hook)(struct planner_s *plnr, plan *pln, 
@@ -755,6 +808,10 @@ struct planner_s {
      hashtab htab_blessed;
      hashtab htab_unblessed;
 
+     /* secondary index of blessed solutions, keyed by layout class */
+     hashtab htab_layout;
+     int layout_wisdom; /* whether to consult htab_layout */
+
      int nthr;
      flags_t flags;
 
@@ -767,10 +824,12 @@ struct planner_s {
      int nplan;    /* number of plans evaluated */
      double pcost, epcost; /* total pcost of measured/estimated plans */
      int nprob;    /* number of problems evaluated */
+     kindstat kstat[PROBLEM_LAST];
 };
 
 planner *X(mkplanner)(void);
 void X(planner_destroy)(planner *ego);
+void X(planner_reset_stats)(planner *ego);
 
 /*
   Iterate over all solvers.   Read:
@@ -899,6 +958,7 @@ typedef struct twid_s {
 } twid;
 
 INT X(twiddle_length)(INT r, const tw_instr *p);
+INT X(twiddle_vl)(const tw_instr *p);
 void X(twiddle_awake)(enum wakefulness wakefulness,
 		      twid **pp, const tw_instr *instr, INT n, INT r, INT m);
 
@@ -963,12 +1023,35 @@ void X(rader_tl_insert)(INT k1, INT k2, INT k3, R *W, rader_tl **tl);
 R *X(rader_tl_find)(INT k1, INT k2, INT k3, rader_tl *t);
 void X(rader_tl_delete)(R *W, rader_tl **tl);
 
+/*-----------------------------------------------------------------------*/
+/* shmtab.c: read-only tables shared between processes */
+typedef void (*shmtab_fill)(R *W, void *data);
+
+extern size_t X(shmtab_bytes); /* made so far, for plan-memory.c */
+IFFTW_EXTERN void (*X(shmtab_lock_hook))(int lockp); /* set by threads */
+int X(shmtab_set_dir)(const char *dir);
+R *X(shmtab_mk)(md5 *key, INT n, shmtab_fill fill, void *data);
+void X(shmtab_free)(R *W);
+
 /*-----------------------------------------------------------------------*/
 /* copy/transposition routines */
 
 /* lower bound to the cache size, for tiled routines */
 #define CACHESIZE 8192
 
+/* software prefetch hints, for loops that stream through more rows
+   than the hardware prefetcher can track */
+#if defined(__GNUC__)
+#  define PREFETCH(p) __builtin_prefetch((const void *)(p), 0, 3)
+#  define PREFETCHW(p) __builtin_prefetch((const void *)(p), 1, 3)
+#else
+#  define PREFETCH(p) ((void)(p))
+#  define PREFETCHW(p) ((void)(p))
+#endif
+
+/* lower bound to the cache line size, in bytes */
+#define CACHELINE 64
+
 INT X(compute_tilesz)(INT vl, int how_many_tiles_in_cache);
 
 void X(tile2d)(INT n0l, INT n0u, INT n1l, INT n1u, INT tilesz,
@@ -1004,6 +1087,8 @@ void X(cpy2d_pair_ci)(R *I0, R *I1, R *O0, R *O1,
 void X(cpy2d_pair_co)(R *I0, R *I1, R *O0, R *O1,
 		      INT n0, INT is0, INT os0,
 		      INT n1, INT is1, INT os1);
+void X(cpynd)(R *I, R *O, int rnk, const iodim *d, INT vl, int nt);
+int X(cpynd_widep)(INT vl);
 
 void X(transpose)(R *I, INT n, INT s0, INT s1, INT vl);
 void X(transpose_tiled)(R *I, INT n, INT s0, INT s1, INT vl);
@@ -1069,6 +1154,12 @@ typedef R E;  /* internal precision of codelets. */
 #  define K(x) ((E) x##L)
 #elif defined(FFTW_QUAD)
 #  define K(x) ((E) x##Q)
+#elif defined(FFTW_DDOUBLE)
+#  if defined(TRIGREAL_IS_QUAD)
+#    define K(x) ((E) x##Q)
+#  else
+#    define K(x) ((E) x##L)
+#  endif
 #else
 #  define K(x) ((E) x)
 #endif
@@ -116,6 +116,9 @@ static void register_solver(planner *ego, solver *s)
 	  n->next_for_same_problem_kind = ego->slvdescs_for_problem_kind[kind];
 	  ego->slvdescs_for_problem_kind[kind] = ego->nslvdesc;
 
+	  n->ninvoke = n->nplan = n->nmeasure = n->nwin = 0;
+	  n->tmeasure = 0.0;
+
 	  ego->nslvdesc++;
      }
 }
@@ -176,6 +179,19 @@ static void md5hash(md5 *m, const problem *p, const planner *plnr)
      X(md5end)(m);
 }
 
+/* hash of the layout class of P, or 0 if P does not have one */
+static int md5hash_layout(md5 *m, const problem *p, const planner *plnr)
+{
+     if (!p->adt->hash_layout)
+	  return 0;
+     X(md5begin)(m);
+     X(md5unsigned)(m, sizeof(R)); /* so we don't mix different precisions */
+     X(md5int)(m, plnr->nthr);
+     p->adt->hash_layout(p, m);
+     X(md5end)(m);
+     return 1;
+}
+
 static int md5eq(const md5sig a, const md5sig b)
 {
      return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
@@ -393,6 +409,19 @@ static void hinsert(planner *ego, const md5sig s, const flags_t *flagsp,
 		 s, flagsp, slvndx );
 }
 
+/* record the solver of a blessed solution under the layout class of
+   the problem, so that problems of the same class can try it first */
+static void hinsert_layout(planner *ego, const problem *p,
+			   const flags_t *flagsp, unsigned slvndx)
+{
+     md5 m;
+
+     if (ego->layout_wisdom && BLISS(*flagsp)
+	 && slvndx != INFEASIBLE_SLVNDX
+	 && md5hash_layout(&m, p, ego)
+	 && !htab_lookup(&ego->htab_layout, m.s, flagsp))
+	  htab_insert(&ego->htab_layout, m.s, flagsp, slvndx);
+}
 
 static void invoke_hook(planner *ego, plan *pln, const problem *p, 
 			int optimalp)
@@ -441,7 +470,8 @@ double X(iestimate_cost)(const planner *ego, const plan *pln, const problem *p)
      return cost;
 }
 
-static void evaluate_plan(planner *ego, plan *pln, const problem *p)
+static void evaluate_plan(planner *ego, plan *pln, const problem *p,
+			  slvdesc *sp)
 {
      if (ESTIMATEP(ego) || !BELIEVE_PCOSTP(ego) || pln->pcost == 0.0) {
 	  ego->nplan++;
@@ -457,6 +487,7 @@ static void evaluate_plan(planner *ego, plan *pln, const problem *p)
 	       ego->epcost += pln->pcost;
 #endif
 	  } else {
+	       crude_time begin = X(get_crude_time)();
 	       double t = X(measure_execution_time)(ego, pln, p);
 	       
 	       if (t < 0) {  /* unavailable cycle counter */
@@ -464,6 +495,8 @@ static void evaluate_plan(planner *ego, plan *pln, const problem *p)
 		    goto estimate;
 	       }
 
+	       ++sp->nmeasure;
+	       sp->tmeasure += X(crude_elapsed)(begin); /* no cost hook */
 	       pln->pcost = t;
 	       ego->pcost += t;
 	       ego->need_timeout_check = 1;
@@ -530,6 +563,7 @@ static plan *search0(planner *ego, const problem *p, unsigned *slvndx,
 	  plan *pln;
 
 	  pln = invoke_solver(ego, p, s, flagsp);
+	  ++sp->ninvoke;
 
 	  if (ego->need_timeout_check) 
 	       if (timeout_p(ego, p)) {
@@ -543,12 +577,13 @@ static plan *search0(planner *ego, const problem *p, unsigned *slvndx,
 		  before we use COULD_PRUNE_NOW_P */
 	       int could_prune_now_p = pln->could_prune_now_p;
 
+	       ++sp->nplan;
 	       if (best) {
 		    if (best_not_yet_timed) {
-			 evaluate_plan(ego, best, p);
+			 evaluate_plan(ego, best, p, ego->slvdescs + *slvndx);
 			 best_not_yet_timed = 0;
 		    }
-		    evaluate_plan(ego, pln, p);
+		    evaluate_plan(ego, pln, p, sp);
 		    if (pln->pcost < best->pcost) {
 			 X(plan_destroy_internal)(best);
 			 best = pln;
@@ -611,9 +646,51 @@ static plan *search(planner *ego, const problem *p, unsigned *slvndx,
 	  }
      }
 
+     if (pln && flagsp->l != flagsp->u)
+	  ++ego->kstat[p->adt->problem_kind].nrelax;
+
+     return pln;
+}
+
+/* Try the solver recorded for the layout class of P.  Unlike exact
+   wisdom, this is only a hint: the solver may not apply to P, in which
+   case we return 0 and the caller searches as usual.  Since no search
+   took place for P itself, the caller must not record the result as
+   wisdom for P. */
+static plan *try_layout_wisdom(planner *ego, const problem *p,
+			       unsigned *slvndx, flags_t *flagsp)
+{
+     md5 m;
+     solution *sol;
+     solver *s;
+     plan *pln;
+     flags_t flags;
+
+     if (!ego->layout_wisdom || ego->wisdom_state != WISDOM_NORMAL
+	 || !md5hash_layout(&m, p, ego))
+	  return 0;
+
+     if (!(sol = htab_lookup(&ego->htab_layout, m.s, flagsp)))
+	  return 0;
+
+     /* SOL may be dangling after invoke_solver(), copy what we need */
+     flags = sol->flags;
+     flags.hash_info |= BLISS(ego->flags);
+     *slvndx = SLVNDX(sol);
+
+     s = ego->slvdescs[*slvndx].slv;
+     if (p->adt->problem_kind != s->adt->problem_kind)
+	  return 0;
+
+     /* children are planned normally, possibly from layout wisdom
+	themselves */
+     pln = invoke_solver(ego, p, s, &flags);
+     if (pln)
+	  *flagsp = flags;
      return pln;
 }
 
+
 #define CHECK_FOR_BOGOSITY						\
      if ((ego->bogosity_hook ?						\
 	  (ego->wisdom_state = ego->bogosity_hook(ego->wisdom_state, p)) \
@@ -628,6 +705,8 @@ static plan *mkplan(planner *ego, const problem *p)
      flags_t flags_of_solution;
      solution *sol;
      solver *s;
+     kindstat *ks = ego->kstat + p->adt->problem_kind;
+     int hinted = 0;
 
      ASSERT_ALIGNED_DOUBLE;
      A(LEQ(PLNR_L(ego), PLNR_U(ego)));
@@ -639,6 +718,7 @@ static plan *mkplan(planner *ego, const problem *p)
 #ifdef FFTW_DEBUG
      check(&ego->htab_blessed);
      check(&ego->htab_unblessed);
+     check(&ego->htab_layout);
 #endif
 
      pln = 0;
@@ -648,6 +728,7 @@ static plan *mkplan(planner *ego, const problem *p)
      ego->timed_out = 0;
 
      ++ego->nprob;
+     ++ks->nprob;
      md5hash(&m, p, ego);
 
      flags_of_solution = ego->flags;
@@ -656,6 +737,8 @@ static plan *mkplan(planner *ego, const problem *p)
 	  if ((sol = hlookup(ego, m.s, &flags_of_solution))) { 
 	       /* wisdom is acceptable */
 	       wisdom_state_t owisdom_state = ego->wisdom_state;
+
+	       ++ks->hit;
 	       
 	       /* this hook is mainly for MPI, to make sure that
 		  wisdom is in sync across all processes for MPI problems */
@@ -698,8 +781,18 @@ static plan *mkplan(planner *ego, const problem *p)
 	       
 	       goto skip_search;
 	  }
-	  else if (ego->nowisdom_hook) /* for MPI, make sure lack of wisdom */
-	       ego->nowisdom_hook(p);  /*   is in sync across all processes */
+	  else {
+	       ++ks->miss;
+	       if (ego->nowisdom_hook) /* for MPI, make sure lack of wisdom */
+		    ego->nowisdom_hook(p);  /* is in sync across all processes */
+	  }
+
+	  pln = try_layout_wisdom(ego, p, &slvndx, &flags_of_solution);
+	  CHECK_FOR_BOGOSITY; 	  /* catch error in child solvers */
+	  if (pln) {
+	       hinted = 1;
+	       goto skip_search;
+	  }
      }
 
  do_search:
@@ -708,11 +801,16 @@ static plan *mkplan(planner *ego, const problem *p)
 	  goto wisdom_is_bogus;
 
      flags_of_solution = ego->flags;
+     ++ks->nsearch;
      pln = search(ego, p, &slvndx, &flags_of_solution);
      CHECK_FOR_BOGOSITY; 	  /* catch error in child solvers */
 
+     if (pln)
+	  ++ego->slvdescs[slvndx].nwin;
+
      if (ego->timed_out) {
 	  A(!pln);
+	  ++ks->ntimeout;
 	  if (PLNR_TIMELIMIT_IMPATIENCE(ego) != 0) {
 	       /* record (below) that this plan has failed because of
 		  timeout */
@@ -731,7 +829,13 @@ static plan *mkplan(planner *ego, const problem *p)
      if (ego->wisdom_state == WISDOM_NORMAL ||
 	 ego->wisdom_state == WISDOM_ONLY) {
 	  if (pln) {
-	       hinsert(ego, m.s, &flags_of_solution, slvndx);
+	       /* a plan from a layout hint is not wisdom for P: the
+		  hint is tried again next time, so that a blessing
+		  pass never turns it into exact wisdom */
+	       if (!hinted) {
+		    hinsert(ego, m.s, &flags_of_solution, slvndx);
+		    hinsert_layout(ego, p, &flags_of_solution, slvndx);
+	       }
 	       invoke_hook(ego, pln, p, 1);
 	  } else {
 	       hinsert(ego, m.s, &flags_of_solution, INFEASIBLE_SLVNDX);
@@ -772,6 +876,8 @@ static void forget(planner *ego, amnesia a)
 	 case FORGET_EVERYTHING:
 	      htab_destroy(&ego->htab_blessed);
 	      mkhashtab(&ego->htab_blessed);
+	      htab_destroy(&ego->htab_layout);
+	      mkhashtab(&ego->htab_layout);
 	      /* fall through */
 	 case FORGET_ACCURSED:
 	      htab_destroy(&ego->htab_unblessed);
@@ -786,18 +892,12 @@ static void forget(planner *ego, amnesia a)
 #define WISDOM_PREAMBLE PACKAGE "-" VERSION " " STRINGIZE(X(wisdom))
 static const char stimeout[] = "TIMEOUT";
 
-/* tantus labor non sit cassus */
-static void exprt(planner *ego, printer *p)
+/* entries of the layout index are prefixed by this name */
+static const char slayout[] = "layout";
+
+static void exprt_htab(planner *ego, printer *p, hashtab *ht, int layout)
 {
      unsigned h;
-     hashtab *ht = &ego->htab_blessed;
-     md5 m;
-
-     signature_of_configuration(&m, ego);
-
-     p->print(p, 
-	      "(" WISDOM_PREAMBLE " #x%M #x%M #x%M #x%M\n",
-	      m.s[0], m.s[1], m.s[2], m.s[3]);
 
      for (h = 0; h < ht->hashsiz; ++h) {
 	  solution *l = ht->solutions + h;
@@ -816,15 +916,45 @@ static void exprt(planner *ego, printer *p)
 
 	       /* qui salvandos salvas gratis
 		  salva me fons pietatis */
-	       p->print(p, "  (%s %d #x%x #x%x #x%x #x%M #x%M #x%M #x%M)\n",
+	       p->print(p, "  (");
+	       if (layout)
+		    p->print(p, "%s ", slayout);
+	       p->print(p, "%s %d #x%x #x%x #x%x #x%M #x%M #x%M #x%M)\n",
 			reg_nam, reg_id, 
 			l->flags.l, l->flags.u, l->flags.timelimit_impatience, 
 			l->s[0], l->s[1], l->s[2], l->s[3]);
 	  }
      }
+}
+
+/* tantus labor non sit cassus */
+static void exprt(planner *ego, printer *p)
+{
+     md5 m;
+
+     signature_of_configuration(&m, ego);
+
+     p->print(p, 
+	      "(" WISDOM_PREAMBLE " #x%M #x%M #x%M #x%M\n",
+	      m.s[0], m.s[1], m.s[2], m.s[3]);
+     exprt_htab(ego, p, &ego->htab_blessed, 0);
+
+     /* the layout index (FFTW_WISDOM_LAYOUT), which cannot be rebuilt
+	from the hashes of the problems above */
+     exprt_htab(ego, p, &ego->htab_layout, 1);
      p->print(p, ")\n");
 }
 
+/* make a backup copy of the hash table (cache the hash) */
+static void htab_backup(const hashtab *ht, hashtab *old)
+{
+     unsigned h, hsiz = ht->hashsiz;
+     *old = *ht;
+     old->solutions = (solution *)MALLOC(hsiz * sizeof(solution), HASHT);
+     for (h = 0; h < hsiz; ++h)
+	  old->solutions[h] = ht->solutions[h];
+}
+
 /* mors stupebit et natura
    cum resurget creatura */
 static int imprt(planner *ego, scanner *sc)
@@ -833,10 +963,10 @@ static int imprt(planner *ego, scanner *sc)
      md5uint sig[4];
      unsigned l, u, timelimit_impatience;
      flags_t flags;
-     int reg_id;
+     int reg_id, layout;
      unsigned slvndx;
-     hashtab *ht = &ego->htab_blessed;
-     hashtab old;
+     hashtab *ht = &ego->htab_blessed, *htl = &ego->htab_layout;
+     hashtab old, oldl;
      md5 m;
 
      if (!sc->scan(sc, 
@@ -851,22 +981,21 @@ static int imprt(planner *ego, scanner *sc)
 	  return 0;
      }
      
-     /* make a backup copy of the hash table (cache the hash) */
-     {
-	  unsigned h, hsiz = ht->hashsiz;
-	  old = *ht;
-	  old.solutions = (solution *)MALLOC(hsiz * sizeof(solution), HASHT);
-	  for (h = 0; h < hsiz; ++h)
-	       old.solutions[h] = ht->solutions[h];
-     }
+     htab_backup(ht, &old);
+     htab_backup(htl, &oldl);
 
      while (1) {
 	  if (sc->scan(sc, ")"))
 	       break;
 
 	  /* qua resurget ex favilla */
-	  if (!sc->scan(sc, "(%*s %d #x%x #x%x #x%x #x%M #x%M #x%M #x%M)",
-			MAXNAM, buf, &reg_id, &l, &u, &timelimit_impatience,
+	  if (!sc->scan(sc, "(%*s", MAXNAM, buf))
+	       goto bad;
+	  layout = !strcmp(buf, slayout);
+	  if (layout && !sc->scan(sc, " %*s", MAXNAM, buf))
+	       goto bad;
+	  if (!sc->scan(sc, " %d #x%x #x%x #x%x #x%M #x%M #x%M #x%M)",
+			&reg_id, &l, &u, &timelimit_impatience,
 			sig + 0, sig + 1, sig + 2, sig + 3))
 	       goto bad;
 
@@ -891,10 +1020,16 @@ static int imprt(planner *ego, scanner *sc)
 	  CK(flags.u == u);
 	  CK(flags.timelimit_impatience == timelimit_impatience);
 
-	  if (!hlookup(ego, sig, &flags))
+	  if (layout) {
+	       if (slvndx == INFEASIBLE_SLVNDX)
+		    goto bad;
+	       if (!htab_lookup(htl, sig, &flags))
+		    htab_insert(htl, sig, &flags, slvndx);
+	  } else if (!hlookup(ego, sig, &flags))
 	       hinsert(ego, sig, &flags, slvndx);
      }
 
+     X(ifree0)(oldl.solutions);
      X(ifree0)(old.solutions);
      return 1;
 
@@ -902,6 +1037,8 @@ static int imprt(planner *ego, scanner *sc)
      /* ``The wisdom of FFTW must be above suspicion.'' */
      X(ifree0)(ht->solutions);
      *ht = old;
+     X(ifree0)(htl->solutions);
+     *htl = oldl;
      return 0;
 }
 
@@ -919,8 +1056,6 @@ planner *X(mkplanner)(void)
      planner *p = (planner *) MALLOC(sizeof(planner), PLANNERS);
 
      p->adt = &padt;
-     p->nplan = p->nprob = 0;
-     p->pcost = p->epcost = 0.0;
      p->hook = 0;
      p->cost_hook = 0;
      p->wisdom_ok_hook = 0;
@@ -942,10 +1077,13 @@ planner *X(mkplanner)(void)
 
      mkhashtab(&p->htab_blessed);
      mkhashtab(&p->htab_unblessed);
+     mkhashtab(&p->htab_layout);
+     p->layout_wisdom = 0;
 
      for (i = 0; i < PROBLEM_LAST; ++i)
 	  p->slvdescs_for_problem_kind[i] = -1;
 
+     X(planner_reset_stats)(p);
      return p;
 }
 
@@ -954,6 +1092,7 @@ void X(planner_destroy)(planner *ego)
      /* destroy hash table */
      htab_destroy(&ego->htab_blessed);
      htab_destroy(&ego->htab_unblessed);
+     htab_destroy(&ego->htab_layout);
 
      /* destroy solvdesc table */
      FORALL_SOLVERS(ego, s, sp, {
@@ -965,6 +1104,26 @@ void X(planner_destroy)(planner *ego)
      X(ifree)(ego); /* dona eis requiem */
 }
 
+void X(planner_reset_stats)(planner *ego)
+{
+     int i;
+
+     ego->nplan = ego->nprob = 0;
+     ego->pcost = ego->epcost = 0.0;
+
+     for (i = 0; i < PROBLEM_LAST; ++i) {
+	  kindstat *ks = ego->kstat + i;
+	  ks->nprob = ks->hit = ks->miss = 0;
+	  ks->nsearch = ks->nrelax = ks->ntimeout = 0;
+     }
+
+     FORALL_SOLVERS(ego, s, sp, {
+	  UNUSED(s);
+	  sp->ninvoke = sp->nplan = sp->nmeasure = sp->nwin = 0;
+	  sp->tmeasure = 0.0;
+     });
+}
+
 plan *X(mkplan_d)(planner *ego, problem *p)
 {
      plan *pln = ego->adt->mkplan(ego, p);
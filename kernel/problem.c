@@ -64,6 +64,7 @@ static const problem_adt padt =
 {
      PROBLEM_UNSOLVABLE,
      unsolvable_hash,
+     0, /* hash_layout */
      unsolvable_zero,
      unsolvable_print,
      unsolvable_destroy
@@ -61,7 +61,7 @@ void X(rader_tl_delete)(R *W, rader_tl **tl)
 
 	  if (t && --t->refcnt <= 0) {
 	       *tp = t->cdr;
-	       X(ifree)(t->W);
+	       X(shmtab_free)(t->W);
 	       X(ifree)(t);
 	  }
      }
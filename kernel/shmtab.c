@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Read-only tables (twiddle factors, Rader omegas, Bluestein
+   sequences) shared between processes.
+
+   When a directory has been set, typically /dev/shm, the table with
+   a given key lives in the file DIR/fftw-<signature>, where the
+   signature is the md5 of the key, of the precision and of the
+   length.  The first process that needs a table computes it in a
+   private temporary file and publishes it atomically with link(2);
+   everybody maps the published file read-only.  Any failure falls
+   back to a private table, so sharing is only an optimization.
+
+   The files are only readable and writable by their owner, and a
+   published file is only mapped if it belongs to us and nobody else
+   can write it, so that another user cannot plant a table for us.
+   Tables smaller than MINSZ bytes stay private: each shared table
+   costs a file, a mapping and at least one page.
+
+   Tables may be made and freed while plans are created or awakened
+   in several threads, so the list of mappings and DIR are guarded by
+   the lock that the threads library installs in X(shmtab_lock_hook).
+
+   The files are never removed by FFTW: they are a cache that
+   outlives the processes, to be cleaned up by whoever set DIR. */
+
+#include "ifftw.h"
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H) && \
+    defined(HAVE_UNISTD_H) && defined(HAVE_FCNTL_H)
+#  define SHMTAB 1
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <errno.h>
+#  include <unistd.h>
+#  include <string.h>
+#  include <stdio.h>
+#endif
+
+size_t X(shmtab_bytes) = 0;
+void (*X(shmtab_lock_hook))(int lockp) = 0;
+
+#define LOCK() do {						\
+     if (X(shmtab_lock_hook)) X(shmtab_lock_hook)(1);		\
+} while (0)
+#define UNLOCK() do {						\
+     if (X(shmtab_lock_hook)) X(shmtab_lock_hook)(0);		\
+} while (0)
+
+static R *mkprivate(INT n, shmtab_fill fill, void *data)
+{
+     R *W = (R *) MALLOC(n * sizeof(R), TWIDDLES);
+     LOCK();
+     X(shmtab_bytes) += n * sizeof(R);
+     UNLOCK();
+     fill(W, data);
+     return W;
+}
+
+#ifdef SHMTAB
+
+#define MAGIC "fftw-tab"
+#define MINSZ 16384
+#define PRECISION_TAG STRINGIZE(X(shmtab))
+
+/* header of a table file, followed by the table itself */
+typedef struct {
+     char magic[8];
+     md5sig s;
+     INT n;
+} header;
+
+/* round the header up so that the table is suitably aligned */
+#define HDRSZ (((sizeof(header) + 63) / 64) * 64)
+
+/* the tables that we have mapped, so that X(shmtab_free) knows
+   whether to munmap or to free */
+typedef struct mapping_s {
+     R *W;
+     size_t len;
+     struct mapping_s *cdr;
+} mapping;
+
+static mapping *mappings = 0;
+static char *dir = 0;
+
+int X(shmtab_set_dir)(const char *d)
+{
+     struct stat st;
+     char *nd = 0;
+
+     if (d) {
+	  if (stat(d, &st) || !S_ISDIR(st.st_mode))
+	       return 0;
+	  nd = (char *) MALLOC(strlen(d) + 1, OTHER);
+	  strcpy(nd, d);
+     }
+
+     LOCK();
+     X(ifree0)(dir);
+     dir = nd;
+     UNLOCK();
+     return 1;
+}
+
+/* map the published table read-only, checking that it is the
+   one we want */
+static R *map(const char *path, const md5sig s, INT n)
+{
+     size_t len = HDRSZ + n * sizeof(R);
+     struct stat st;
+     const header *h;
+     void *a;
+     mapping *m;
+     int fd;
+
+     if ((fd = open(path, O_RDONLY)) < 0)
+	  return 0;
+     if (fstat(fd, &st) || (size_t) st.st_size != len
+	 || !S_ISREG(st.st_mode) || st.st_uid != geteuid()
+	 || (st.st_mode & (S_IWGRP | S_IWOTH))) {
+	  close(fd);
+	  return 0;
+     }
+     a = mmap(0, len, PROT_READ, MAP_SHARED, fd, 0);
+     close(fd);
+     if (a == MAP_FAILED)
+	  return 0;
+
+     h = (const header *) a;
+     if (memcmp(h->magic, MAGIC, 8) || h->n != n
+	 || memcmp(h->s, s, sizeof(md5sig))) {
+	  munmap(a, len);
+	  return 0;
+     }
+
+     m = (mapping *) MALLOC(sizeof(mapping), TWIDDLES);
+     m->W = (R *) ((char *) a + HDRSZ);
+     m->len = len;
+     LOCK();
+     X(shmtab_bytes) += len;
+     m->cdr = mappings;
+     mappings = m;
+     UNLOCK();
+     return m->W;
+}
+
+/* compute the table in a private file and link it to PATH, unless
+   somebody else got there first */
+static int publish(const char *path, const md5sig s, INT n,
+		   shmtab_fill fill, void *data)
+{
+     size_t len = HDRSZ + n * sizeof(R);
+     char *tmp;
+     header *h;
+     void *a;
+     int fd, ok = 0;
+
+     tmp = (char *) MALLOC(strlen(path) + 32, OTHER);
+     sprintf(tmp, "%s.%ld", path, (long) getpid());
+     if ((fd = open(tmp, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0)
+	  goto done;
+     if (ftruncate(fd, (off_t) len) == 0) {
+	  a = mmap(0, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	  if (a != MAP_FAILED) {
+	       h = (header *) a;
+	       memcpy(h->magic, MAGIC, 8);
+	       memcpy(h->s, s, sizeof(md5sig));
+	       h->n = n;
+	       fill((R *) ((char *) a + HDRSZ), data);
+	       munmap(a, len);
+	       ok = (link(tmp, path) == 0 || errno == EEXIST);
+	  }
+     }
+     close(fd);
+     unlink(tmp);
+ done:
+     X(ifree)(tmp);
+     return ok;
+}
+
+R *X(shmtab_mk)(md5 *key, INT n, shmtab_fill fill, void *data)
+{
+     char *path = 0;
+     R *W;
+
+     if (n * sizeof(R) < MINSZ)
+	  return mkprivate(n, fill, data);
+
+     /* long double, __float128 and double-double are all 16 bytes,
+	so tell the precisions apart by name */
+     X(md5puts)(key, PRECISION_TAG);
+     X(md5INT)(key, n);
+     X(md5end)(key);
+
+     LOCK();
+     if (dir) {
+	  path = (char *) MALLOC(strlen(dir) + 64, OTHER);
+	  sprintf(path, "%s/fftw-%08lx%08lx%08lx%08lx", dir,
+		  (unsigned long) key->s[0], (unsigned long) key->s[1],
+		  (unsigned long) key->s[2], (unsigned long) key->s[3]);
+     }
+     UNLOCK();
+     if (!path)
+	  return mkprivate(n, fill, data);
+
+     if (!(W = map(path, key->s, n))
+	 && !(publish(path, key->s, n, fill, data)
+	      && (W = map(path, key->s, n))))
+	  W = mkprivate(n, fill, data);
+
+     X(ifree)(path);
+     return W;
+}
+
+void X(shmtab_free)(R *W)
+{
+     mapping **mp, *m;
+
+     LOCK();
+     for (mp = &mappings; (m = *mp); mp = &m->cdr) {
+	  if (m->W == W) {
+	       *mp = m->cdr;
+	       break;
+	  }
+     }
+     UNLOCK();
+
+     if (m) {
+	  munmap((char *) W - HDRSZ, m->len);
+	  X(ifree)(m);
+     } else
+	  X(ifree0)(W);
+}
+
+#else /* no mmap: every table is private */
+
+int X(shmtab_set_dir)(const char *d)
+{
+     return d == 0;
+}
+
+R *X(shmtab_mk)(md5 *key, INT n, shmtab_fill fill, void *data)
+{
+     UNUSED(key);
+     return mkprivate(n, fill, data);
+}
+
+void X(shmtab_free)(R *W)
+{
+     X(ifree0)(W);
+}
+
+#endif
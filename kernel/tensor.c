@@ -86,6 +86,40 @@ void X(tensor_md5)(md5 *p, const tensor *t)
      }
 }
 
+/* layout class of a stride: zero, unit, or the sign and the
+   binary order of magnitude of the stride */
+static int stride_class(INT s)
+{
+     int c = 1;
+     INT a = IABS(s);
+
+     if (a == 0)
+	  return 0;
+     while (a > 1) {
+	  a >>= 1;
+	  ++c;
+     }
+     return s < 0 ? -c : c;
+}
+
+/* Hash T up to its layout class: sizes are hashed exactly, strides
+   only up to stride_class().  Tensors that differ in padding
+   (leading dimensions, batch distances) thus usually hash equally. */
+void X(tensor_md5_layout)(md5 *p, const tensor *t)
+{
+     int i;
+     X(md5int)(p, t->rnk);
+     if (FINITE_RNK(t->rnk)) {
+	  for (i = 0; i < t->rnk; ++i) {
+	       const iodim *q = t->dims + i;
+	       X(md5INT)(p, q->n);
+	       X(md5int)(p, stride_class(q->is));
+	       X(md5int)(p, stride_class(q->os));
+	       X(md5int)(p, q->is == q->os);
+	  }
+     }
+}
+
 /* treat a (rank <= 1)-tensor as a rank-1 tensor, extracting
    appropriate n, is, and os components */
 int X(tensor_tornk1)(const tensor *t, INT *n, INT *is, INT *os)
@@ -98,6 +98,12 @@ static double elapsed_since(crude_time t0)
 
 #endif /* !HAVE_GETTIMEOFDAY */
 
+/* local time, without the cost hook (which may communicate) */
+double X(crude_elapsed)(crude_time t0)
+{
+     return elapsed_since(t0);
+}
+
 double X(elapsed_since)(const planner *plnr, const problem *p, crude_time t0)
 {
      double t = elapsed_since(t0);
@@ -37,8 +37,14 @@
 #  define COS cosq
 #  define SIN sinq
 #  define KTRIG(x) (x##Q)
+#  ifdef __cplusplus
+   extern "C" {
+#  endif
    extern __float128 sinq(__float128 x);
    extern __float128 cosq(__float128 x);
+#  ifdef __cplusplus
+   }
+#  endif
 #else
 #  define COS cos
 #  define SIN sin
@@ -216,9 +222,11 @@ triggen *X(mktriggen)(enum wakefulness wakefulness, INT n)
      }
 
      if (!p->cexp) {
+#ifndef FFTW_DDOUBLE /* where R is a pair of doubles of the size of trigreal */
 	  if (sizeof(trigreal) == sizeof(R))
 	       p->cexp = (void (*)(triggen *, INT, R *))p->cexpl;
 	  else
+#endif
 	       p->cexp = cexp_generic;
      }
      if (!p->rotate)     
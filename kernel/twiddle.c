@@ -121,20 +121,27 @@ INT X(twiddle_length)(INT r, const tw_instr *p)
      return twlen0(r, p, &vl);
 }
 
-static R *compute(enum wakefulness wakefulness,
-		  const tw_instr *instr, INT n, INT r, INT m)
+/* the number of iterations that share each X(twiddle_length) block
+   of the table */
+INT X(twiddle_vl)(const tw_instr *p)
 {
-     INT ntwiddle, j, vl;
-     R *W, *W0;
-     const tw_instr *p;
-     triggen *t = X(mktriggen)(wakefulness, n);
-
-     p = instr;
-     ntwiddle = twlen0(r, p, &vl);
+     INT vl;
+     twlen0(1, p, &vl);
+     return vl;
+}
 
-     A(m % vl == 0);
+typedef struct {
+     enum wakefulness wakefulness;
+     const tw_instr *instr;
+     INT n, r, m, vl;
+} closure;
 
-     W0 = W = (R *)MALLOC((ntwiddle * (m / vl)) * sizeof(R), TWIDDLES);
+static void fill(R *W, void *data)
+{
+     const closure *c = (const closure *) data;
+     const tw_instr *instr = c->instr, *p;
+     INT n = c->n, r = c->r, m = c->m, vl = c->vl, j;
+     triggen *t = X(mktriggen)(c->wakefulness, n);
 
      for (j = 0; j < m; j += vl) {
           for (p = instr; p->op != TW_NEXT; ++p) {
@@ -191,7 +198,40 @@ static R *compute(enum wakefulness wakefulness,
      }
 
      X(triggen_destroy)(t);
-     return W0;
+}
+
+static R *compute(enum wakefulness wakefulness,
+		  const tw_instr *instr, INT n, INT r, INT m)
+{
+     INT ntwiddle;
+     const tw_instr *p;
+     closure c;
+     md5 key;
+
+     ntwiddle = twlen0(r, instr, &c.vl);
+     A(m % c.vl == 0);
+
+     c.wakefulness = wakefulness;
+     c.instr = instr;
+     c.n = n; c.r = r; c.m = m;
+
+     /* the table is identified by its contents, not by the address
+	of INSTR, which differs from process to process */
+     X(md5begin)(&key);
+     X(md5puts)(&key, "twiddle");
+     X(md5int)(&key, (int) wakefulness);
+     X(md5INT)(&key, n);
+     X(md5INT)(&key, r);
+     X(md5INT)(&key, m);
+     for (p = instr; ; ++p) {
+	  X(md5int)(&key, p->op);
+	  X(md5int)(&key, p->v);
+	  X(md5int)(&key, p->i);
+	  if (p->op == TW_NEXT)
+	       break;
+     }
+
+     return X(shmtab_mk)(&key, ntwiddle * (m / c.vl), fill, &c);
 }
 
 static void mktwiddle(enum wakefulness wakefulness,
@@ -231,7 +271,7 @@ static void twiddle_destroy(twid **pp)
 	  for (q = &twlist[hash(p->n, p->r)]; *q; q = &((*q)->cdr)) {
 	       if (*q == p) {
 		    *q = p->cdr;
-		    X(ifree)(p->W);
+		    X(shmtab_free)(p->W);
 		    X(ifree)(p);
 		    *pp = 0;
 		    return;
@@ -32,6 +32,9 @@ static const struct my_option options[] =
   {"accuracy-rounds", REQARG, 405},
   {"impulse-accuracy-rounds", REQARG, 406},
   {"can-do", REQARG, 'd'},
+  {"concurrent", REQARG, 408},
+  {"concurrent-shared", NOARG, 410},
+  {"concurrent-threads", REQARG, 409},
   {"help", NOARG, 'h'},
   {"info", REQARG, 'i'},
   {"info-all", NOARG, 'I'},
@@ -40,8 +43,11 @@ static const struct my_option options[] =
   {"random-seed", REQARG, 404},
   {"report-benchmark", NOARG, 320},
   {"report-mflops", NOARG, 300},
+  {"report-roofline", NOARG, 350},
+  {"report-samples", NOARG, 340},
   {"report-time", NOARG, 310},
   {"report-verbose", NOARG, 330},
+  {"replay", REQARG, 407},
   {"speed", REQARG, 's'},
   {"setup-speed", REQARG, 'S'},
   {"time-min", REQARG, 't'},
@@ -62,12 +68,14 @@ int bench_main(int argc, char *argv[])
      int rounds = 10;
      int iarounds = 0;
      int arounds = 1; /* this is too low for precise results */
+     int cthreads = 2, cshared = 0;
      int c;
 
      report = report_verbose; /* default */
      verbose = 0;
 
-     tol = SINGLE_PRECISION ? 1.0e-3 : (QUAD_PRECISION ? 1e-29 : 1.0e-10);
+     tol = SINGLE_PRECISION ? 1.0e-3 : (QUAD_PRECISION ? 1e-29 :
+					(DDOUBLE_PRECISION ? 1e-27 : 1.0e-10));
 
      main_init(&argc, &argv);
 
@@ -135,6 +143,14 @@ int bench_main(int argc, char *argv[])
 		   report = report_verbose;
 		   break;
 
+	      case 340: /* --report-samples */
+		   report = report_samples;
+		   break;
+
+	      case 350: /* --report-roofline */
+		   report = report_roofline;
+		   break;
+
 	      case 400: /* --print-time-min */
 		   timer_init(tmin, repeat);
 		   ovtpvt("%g\n", time_min);
@@ -149,6 +165,8 @@ int bench_main(int argc, char *argv[])
 			ovtpvt("single\n");
 		   else if (QUAD_PRECISION)
 			ovtpvt("quad\n");
+		   else if (DDOUBLE_PRECISION)
+			ovtpvt("double-double\n");
 		   else if (LDOUBLE_PRECISION)
 			ovtpvt("long-double\n");
 		   else if (DOUBLE_PRECISION)
@@ -172,6 +190,24 @@ int bench_main(int argc, char *argv[])
 	      case 406: /* --impulse-accuracy-rounds */
 		   iarounds = atoi(my_optarg);
 		   break;
+
+	      case 407: /* --replay */
+		   timer_init(tmin, repeat);
+		   replay(my_optarg);
+		   break;
+
+	      case 408: /* --concurrent */
+		   timer_init(tmin, repeat);
+		   concurrent(my_optarg, cthreads, cshared);
+		   break;
+
+	      case 409: /* --concurrent-threads */
+		   cthreads = atoi(my_optarg);
+		   break;
+
+	      case 410: /* --concurrent-shared */
+		   cshared = 1;
+		   break;
 		   
 	      case '?':
 		   /* my_getopt() already printed an error message. */
@@ -42,6 +42,9 @@ typedef float bench_real;
 typedef long double bench_real;
 #elif defined(BENCHFFT_QUAD)
 typedef __float128 bench_real;
+#elif defined(BENCHFFT_DDOUBLE)
+#include "dd.h"
+typedef dd bench_real;
 #else
 typedef double bench_real;
 #endif
@@ -51,12 +54,19 @@ typedef bench_real bench_complex[2];
 #define c_re(c)  ((c)[0])
 #define c_im(c)  ((c)[1])
 
+#undef DDOUBLE_PRECISION
+#ifdef BENCHFFT_DDOUBLE
+#define DDOUBLE_PRECISION 1
+#else
+#define DDOUBLE_PRECISION 0
+#endif
+
 #undef DOUBLE_PRECISION
 #define DOUBLE_PRECISION (sizeof(bench_real) == sizeof(double))
 #undef SINGLE_PRECISION
 #define SINGLE_PRECISION (!DOUBLE_PRECISION && sizeof(bench_real) == sizeof(float))
 #undef LDOUBLE_PRECISION
-#define LDOUBLE_PRECISION (!DOUBLE_PRECISION && sizeof(bench_real) == sizeof(long double))
+#define LDOUBLE_PRECISION (!DOUBLE_PRECISION && !DDOUBLE_PRECISION && sizeof(bench_real) == sizeof(long double))
 
 #undef QUAD_PRECISION
 #ifdef BENCHFFT_QUAD
@@ -129,6 +139,9 @@ typedef struct {
 
      /* another internal hack to avoid passing around too many parameters */
      double setup_time;
+
+     /* flops actually executed, if setup() knows them; 0 otherwise */
+     double flops;
 } bench_problem;
 
 extern int verbose;
@@ -139,7 +152,8 @@ extern int always_pad_real;
 
 #define LIBBENCH_TIMER 0
 #define USER_TIMER 1
-#define BENCH_NTIMERS 2
+#define REPLAY_TIMER 2
+#define BENCH_NTIMERS 3
 extern void timer_start(int which_timer);
 extern double timer_stop(int which_timer);
 
@@ -147,6 +161,10 @@ extern int can_do(bench_problem *p);
 extern void setup(bench_problem *p);
 extern void doit(int iter, bench_problem *p);
 extern void done(bench_problem *p);
+extern void doit_shared(int iter, bench_problem *p, bench_problem *master);
+extern double run_concurrently(int nthr,
+			       void (*proc)(int ithr, void *data),
+			       void *data);
 extern void main_init(int *argc, char ***argv);
 extern void cleanup(void);
 extern void verify(const char *param, int rounds, double tol);
@@ -34,6 +34,10 @@ void report_mflops(const bench_problem *p, double *t, int st);
 void report_time(const bench_problem *p, double *t, int st);
 void report_benchmark(const bench_problem *p, double *t, int st);
 void report_verbose(const bench_problem *p, double *t, int st);
+void report_samples(const bench_problem *p, double *t, int st);
+void report_roofline(const bench_problem *p, double *t, int st);
+
+void sprintf_time(double x, char *buf, int buflen);
 
 void report_can_do(const char *param);
 void report_info(const char *param);
@@ -43,6 +47,8 @@ extern int aligned_main(int argc, char *argv[]);
 extern int bench_main(int argc, char *argv[]);
 
 extern void speed(const char *param, int setup_only);
+extern void replay(const char *fname);
+extern void concurrent(const char *param, int nthr, int shared);
 extern void accuracy(const char *param, int rounds, int impulse_rounds);
 
 extern double mflops(const bench_problem *p, double t);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2001 Matteo Frigo
+ * Copyright (c) 2001 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Concurrent throughput: NTHR threads execute the same problem at
+   the same time, each on its own arrays, with either one plan per
+   thread or one plan shared by all of them.  We compare the
+   aggregate rate against that of a single thread running alone. */
+
+#include "bench.h"
+
+typedef struct {
+     bench_problem **p;
+     int iter, shared;
+} closure;
+
+static void body(int ithr, void *data)
+{
+     closure *c = (closure *) data;
+
+     if (c->shared)
+	  doit_shared(c->iter, c->p[ithr], c->p[0]);
+     else
+	  doit(c->iter, c->p[ithr]);
+}
+
+/* minimum over time_repeat runs of NTHR threads doing ITER
+   transforms each */
+static double run(closure *c, int nthr)
+{
+     int k;
+     double tmin = 1.0e20, y;
+
+     for (k = 0; k < time_repeat; ++k) {
+	  /* the time does not include starting the threads */
+	  y = bench_cost_postprocess(run_concurrently(nthr, body, c));
+	  if (y >= 0 && y < tmin)
+	       tmin = y;
+     }
+     return tmin;
+}
+
+void concurrent(const char *param, int nthr, int shared)
+{
+     bench_problem **p;
+     closure c;
+     int i;
+     double t1 = 0.0, tn, rate1, raten;
+     char b1[64], bn[64], bsetup[64];
+
+     BENCH_ASSERT(nthr > 0);
+     p = (bench_problem **) bench_malloc(nthr * sizeof(bench_problem *));
+
+     for (i = 0; i < nthr; ++i) {
+	  p[i] = problem_parse(param);
+	  if (i == 0)
+	       BENCH_ASSERT(can_do(p[i]));
+	  problem_alloc(p[i]);
+	  problem_zero(p[i]);
+     }
+
+     timer_start(LIBBENCH_TIMER);
+     setup(p[0]);
+     p[0]->setup_time = bench_cost_postprocess(timer_stop(LIBBENCH_TIMER));
+     for (i = 1; i < nthr; ++i)
+	  if (!shared)
+	       setup(p[i]);
+
+     /* see speed() */
+     for (i = 0; i < nthr; ++i)
+	  problem_zero(p[i]);
+
+     c.p = p;
+     c.shared = shared;
+
+     /* calibrate the iteration count on one thread */
+     for (c.iter = 1; c.iter < (1<<30); c.iter *= 2) {
+	  t1 = run(&c, 1);
+	  if (t1 >= time_min)
+	       break;
+     }
+
+     tn = run(&c, nthr);
+
+     t1 /= c.iter;
+     tn /= c.iter;
+     rate1 = 1.0 / t1;
+     raten = nthr / tn;
+
+     sprintf_time(t1, b1, 64);
+     sprintf_time(tn, bn, 64);
+     sprintf_time(p[0]->setup_time, bsetup, 64);
+     ovtpvt("Problem: %s, setup: %s, threads: %d, %s\n",
+	    p[0]->pstring, bsetup, nthr,
+	    shared ? "shared plan" : "private plans");
+     ovtpvt("  alone: %s, %.5g transforms/s, ``mflops'': %.5g\n",
+	    b1, rate1, mflops(p[0], t1));
+     ovtpvt("  concurrent: %s, %.5g transforms/s, ``mflops'': %.5g\n",
+	    bn, raten, nthr * mflops(p[0], tn));
+     ovtpvt("  speedup: %.3g, efficiency: %.1f%%\n",
+	    raten / rate1, 100.0 * raten / (nthr * rate1));
+
+     for (i = 0; i < nthr; ++i) {
+	  if (i == 0 || !shared)
+	       done(p[i]);
+	  problem_destroy(p[i]);
+     }
+     bench_free(p);
+}
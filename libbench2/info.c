@@ -53,6 +53,7 @@ void report_info_all(void)
      ovtpvt("(benchmark-precision \"%s\")\n", 
 	    SINGLE_PRECISION ? "single" : 
 	    (LDOUBLE_PRECISION ? "long-double" : 
-	     (QUAD_PRECISION ? "quad" : "double")));
+	     (QUAD_PRECISION ? "quad" :
+	      (DDOUBLE_PRECISION ? "double-double" : "double"))));
 }
 
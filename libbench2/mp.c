@@ -61,7 +61,7 @@ static void fromreal(REAL x, N a)
 
 	  x *= RADIX;
 	  y = (REAL) ((int) x);
-	  AD[i] = (DG)y;
+	  AD[i] = (DG)((int) y);
 	  x -= y;
      }
 }
@@ -588,7 +588,7 @@ static void compare(int n, N *a, N *b, double *err)
      n1 = n2 = ninf = 0.0;
 
 #    define DO(x1, x2, xinf, var) { 			\
-     double d = var;					\
+     double d = (double) (var);				\
      if (d < 0) d = -d;					\
      x1 += d; x2 += d * d; if (d > xinf) xinf = d;	\
 }
@@ -249,6 +249,7 @@ bench_problem *problem_parse(const char *s)
      p->scrambled_in = p->scrambled_out = 0;
      p->sz = p->vecsz = 0;
      p->ini = p->outi = 0;
+     p->flops = 0;
      p->pstring = (char *) bench_malloc(sizeof(char) * (strlen(s) + 1));
      strcpy(p->pstring, s);
 
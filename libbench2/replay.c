@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2001 Matteo Frigo
+ * Copyright (c) 2001 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Replay a workload trace.
+
+   A trace is a text file with one record per line:
+
+       <problem> [<count> [<interarrival> [<thread>]]]
+
+   meaning that <thread> issues <count> executions of <problem>, one
+   every <interarrival> seconds.  Records of the same thread are
+   issued one after the other, in file order; different threads run
+   concurrently on the trace clock.  Blank lines and lines starting
+   with '#' are ignored.  Defaults are count 1, interarrival 0 (back
+   to back) and thread 0.
+
+   All problems are set up (planned) before the clock starts.  The
+   executions of all threads are then merged by arrival time and run
+   one at a time, each on its own arrays, so that different plans
+   evict each other from the cache as they would in production.  An
+   execution that arrives while another is running waits, and the
+   wait counts toward its latency. */
+
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAXLINE 1024
+
+typedef struct {
+     bench_problem *p;
+     int count, thread;
+     double interarrival;
+     int ndone;
+     double *latency; /* count entries */
+     double service;  /* total */
+} record;
+
+typedef struct {
+     int thread;
+     int cur;          /* next record of this thread, or nrec */
+     double clock;     /* arrival time of the last execution issued */
+} stream;
+
+static int next_record(const record *r, int nrec, int i, int thread)
+{
+     for (; i < nrec; ++i)
+	  if (r[i].thread == thread)
+	       return i;
+     return nrec;
+}
+
+static int read_trace(const char *fname, record **rp)
+{
+     FILE *f;
+     char line[MAXLINE], pstring[MAXLINE];
+     record *r = 0;
+     int nrec = 0, nalloc = 0;
+
+     f = fopen(fname, "r");
+     if (!f) {
+	  ovtpvt_err("cannot open trace file %s\n", fname);
+	  BENCH_ASSERT(0);
+     }
+
+     while (fgets(line, MAXLINE, f)) {
+	  int count = 1, thread = 0;
+	  double interarrival = 0.0;
+
+	  if (sscanf(line, "%s %d %lf %d", pstring,
+		     &count, &interarrival, &thread) < 1
+	      || pstring[0] == '#')
+	       continue;
+
+	  BENCH_ASSERT(count > 0 && interarrival >= 0.0);
+
+	  if (nrec == nalloc) {
+	       record *r1;
+	       nalloc = nalloc ? 2 * nalloc : 16;
+	       r1 = (record *) bench_malloc(nalloc * sizeof(record));
+	       if (r) {
+		    memcpy(r1, r, nrec * sizeof(record));
+		    bench_free(r);
+	       }
+	       r = r1;
+	  }
+
+	  r[nrec].p = problem_parse(pstring);
+	  r[nrec].count = count;
+	  r[nrec].interarrival = interarrival;
+	  r[nrec].thread = thread;
+	  r[nrec].ndone = 0;
+	  r[nrec].latency = (double *) bench_malloc(count * sizeof(double));
+	  r[nrec].service = 0.0;
+	  ++nrec;
+     }
+
+     fclose(f);
+     *rp = r;
+     return nrec;
+}
+
+static int cmpdouble(const void *a, const void *b)
+{
+     double x = *(const double *) a, y = *(const double *) b;
+     return (x < y) ? -1 : (x > y);
+}
+
+static void report_record(const record *r)
+{
+     char bmin[64], bmed[64], b99[64], bmax[64], bsvc[64], bsetup[64];
+     double *t = r->latency;
+     int n = r->count;
+
+     qsort(t, n, sizeof(double), cmpdouble);
+     sprintf_time(t[0], bmin, 64);
+     sprintf_time(t[n / 2], bmed, 64);
+     sprintf_time(t[(99 * (n - 1)) / 100], b99, 64);
+     sprintf_time(t[n - 1], bmax, 64);
+     sprintf_time(r->service / n, bsvc, 64);
+     sprintf_time(r->p->setup_time, bsetup, 64);
+
+     ovtpvt("Problem: %s, thread: %d, count: %d, setup: %s, "
+	    "service: %s, %s: %.5g\n",
+	    r->p->pstring, r->thread, n, bsetup, bsvc,
+	    tensor_sz(r->p->sz) == 1 ? "fp-move/us" : "``mflops''",
+	    mflops(r->p, r->service / n));
+     ovtpvt("  latency: min %s, median %s, 99%% %s, max %s\n",
+	    bmin, bmed, b99, bmax);
+}
+
+void replay(const char *fname)
+{
+     record *r;
+     stream *s;
+     int nrec, nstream, i, j, nexec = 0;
+     double wall, work = 0.0;
+     char bwall[64];
+
+     nrec = read_trace(fname, &r);
+     BENCH_ASSERT(nrec > 0);
+
+     /* plan everything first */
+     for (i = 0; i < nrec; ++i) {
+	  bench_problem *p = r[i].p;
+	  BENCH_ASSERT(can_do(p));
+	  problem_alloc(p);
+	  problem_zero(p);
+	  timer_start(LIBBENCH_TIMER);
+	  setup(p);
+	  p->setup_time = bench_cost_postprocess(timer_stop(LIBBENCH_TIMER));
+	  problem_zero(p);
+     }
+
+     /* one stream per thread, in order of first appearance */
+     s = (stream *) bench_malloc(nrec * sizeof(stream));
+     for (nstream = i = 0; i < nrec; ++i) {
+	  for (j = 0; j < nstream; ++j)
+	       if (s[j].thread == r[i].thread)
+		    break;
+	  if (j == nstream) {
+	       s[j].thread = r[i].thread;
+	       s[j].cur = i;
+	       s[j].clock = 0.0;
+	       ++nstream;
+	  }
+     }
+
+     timer_start(REPLAY_TIMER);
+     for (;;) {
+	  int best = -1;
+	  double arrival = 0.0, start, finish;
+	  record *q;
+
+	  /* earliest pending arrival; ties go to the earlier thread */
+	  for (j = 0; j < nstream; ++j) {
+	       if (s[j].cur < nrec) {
+		    double a = s[j].clock + r[s[j].cur].interarrival;
+		    if (best < 0 || a < arrival) {
+			 best = j;
+			 arrival = a;
+		    }
+	       }
+	  }
+	  if (best < 0)
+	       break;
+
+	  while ((start = timer_stop(REPLAY_TIMER)) < arrival)
+	       ; /* idle until the execution arrives */
+
+	  q = r + s[best].cur;
+	  doit(1, q->p);
+	  finish = timer_stop(REPLAY_TIMER);
+
+	  q->latency[q->ndone++] = finish - arrival;
+	  q->service += finish - start;
+	  s[best].clock = arrival;
+	  if (q->ndone == q->count)
+	       s[best].cur = next_record(r, nrec, s[best].cur + 1,
+					 s[best].thread);
+	  ++nexec;
+     }
+     wall = timer_stop(REPLAY_TIMER);
+
+     for (i = 0; i < nrec; ++i) {
+	  report_record(r + i);
+	  /* mflops() is inversely proportional to the time */
+	  work += r[i].count * mflops(r[i].p, 1.0);
+	  done(r[i].p);
+	  problem_destroy(r[i].p);
+	  bench_free(r[i].latency);
+     }
+
+     sprintf_time(wall, bwall, 64);
+     ovtpvt("Replay: %s, %d executions, %d threads, time: %s, "
+	    "executions/s: %.5g, ``mflops'': %.5g\n",
+	    fname, nexec, nstream, bwall, nexec / wall, work / wall);
+
+     bench_free(s);
+     bench_free(r);
+}
@@ -90,7 +90,18 @@ void report_benchmark(const bench_problem *p, double *t, int st)
      ovtpvt("%.5g %.8g %g\n", mflops(p, s.min), s.min, p->setup_time);
 }
 
-static void sprintf_time(double x, char *buf, int buflen)
+/* all the measurements, unsorted, for external statistics */
+void report_samples(const bench_problem *p, double *t, int st)
+{
+     int i;
+     UNUSED(p);
+     ovtpvt("(");
+     for (i = 0; i < st; ++i)
+	  ovtpvt(i ? " %.8g" : "%.8g", t[i]);
+     ovtpvt(")\n");
+}
+
+void sprintf_time(double x, char *buf, int buflen)
 {
 #ifdef HAVE_SNPRINTF
 #  define MY_SPRINTF(a, b) snprintf(buf, buflen, a, b)
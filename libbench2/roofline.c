@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2001 Matteo Frigo
+ * Copyright (c) 2001 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Roofline report: the flops actually executed and the minimum
+   number of bytes moved by a transform, against the peak bandwidth
+   and flop rate of the machine as measured by two small probes. */
+
+#include "bench.h"
+
+/* STREAM-like triad over arrays much larger than any cache */
+#define STREAM_N (4 * 1024 * 1024)
+
+/* independent multiply-add chains, enough to fill the pipelines of
+   a few SIMD units */
+#define FMA_CHAINS 32
+#define FMA_ITER 4096
+
+static double peak_bw = 0.0, peak_flops = 0.0;
+
+/* static, so that the chains cannot be sunk past timer_stop() */
+static bench_real acc[FMA_CHAINS];
+
+static double stream_probe(void)
+{
+     bench_real *a, *b, *c, s = 3.0;
+     int i, k;
+     double t, tmin = 1.0e20;
+
+     a = (bench_real *) bench_malloc(STREAM_N * sizeof(bench_real));
+     b = (bench_real *) bench_malloc(STREAM_N * sizeof(bench_real));
+     c = (bench_real *) bench_malloc(STREAM_N * sizeof(bench_real));
+     for (i = 0; i < STREAM_N; ++i) {
+	  a[i] = 0.0; b[i] = 1.0; c[i] = 2.0;
+     }
+
+     for (k = 0; k < time_repeat; ++k) {
+	  timer_start(LIBBENCH_TIMER);
+	  for (i = 0; i < STREAM_N; ++i)
+	       a[i] = b[i] + s * c[i];
+	  t = bench_cost_postprocess(timer_stop(LIBBENCH_TIMER));
+	  if (t > 0 && t < tmin)
+	       tmin = t;
+	  s = a[k]; /* keep the loop alive */
+     }
+
+     bench_free(c);
+     bench_free(b);
+     bench_free(a);
+
+     /* two loads and a store per element */
+     return 3.0 * STREAM_N * sizeof(bench_real) / tmin;
+}
+
+static double fma_probe(void)
+{
+     bench_real x = 0.999999, y = 1.0e-7;
+     int i, j, k, iter;
+     double t, tmin = 1.0e20;
+
+     for (iter = FMA_ITER; iter < (1<<30); iter *= 2) {
+	  tmin = 1.0e20;
+	  for (k = 0; k < time_repeat; ++k) {
+	       for (j = 0; j < FMA_CHAINS; ++j)
+		    acc[j] = (bench_real) j;
+	       timer_start(LIBBENCH_TIMER);
+	       for (i = 0; i < iter; ++i)
+		    for (j = 0; j < FMA_CHAINS; ++j)
+			 acc[j] = acc[j] * x + y;
+	       t = bench_cost_postprocess(timer_stop(LIBBENCH_TIMER));
+	       if (t > 0 && t < tmin)
+		    tmin = t;
+	       for (j = 1; j < FMA_CHAINS; ++j)
+		    acc[0] += acc[j];
+	       y = acc[0] * 1.0e-30 + 1.0e-7; /* keep the loop alive */
+	  }
+	  if (tmin < 1.0e20 && tmin >= time_min)
+	       break;
+     }
+
+     return 2.0 * FMA_CHAINS * (double) iter / tmin;
+}
+
+static void probe(void)
+{
+     if (peak_bw == 0.0) {
+	  peak_bw = stream_probe();
+	  peak_flops = fma_probe();
+	  ovtpvt("Machine: stream %.4g GB/s, multiply-add %.4g GFLOP/s, "
+		 "balance %.3g flop/byte\n",
+		 peak_bw * 1.0e-9, peak_flops * 1.0e-9, peak_flops / peak_bw);
+     }
+}
+
+/* compulsory traffic: read the input once and write the output once */
+static double min_bytes(const bench_problem *p)
+{
+     double n = tensor_sz(p->sz), v = tensor_sz(p->vecsz), h = n;
+     double in, out;
+
+     if (FINITE_RNK(p->sz->rnk) && p->sz->rnk > 0) {
+	  int nl = p->sz->dims[p->sz->rnk - 1].n;
+	  h = (n / nl) * (nl / 2 + 1);
+     }
+
+     switch (p->kind) {
+	 case PROBLEM_COMPLEX:
+	      in = out = 2 * n;
+	      break;
+	 case PROBLEM_REAL:
+	      in = (p->sign < 0) ? n : 2 * h;
+	      out = (p->sign < 0) ? 2 * h : n;
+	      break;
+	 default:
+	      in = out = n;
+	      break;
+     }
+     return (in + out) * v * sizeof(bench_real);
+}
+
+void report_roofline(const bench_problem *p, double *t, int st)
+{
+     double tmin = t[0], flops, bytes, gflops, gbs, attainable;
+     char btmin[64];
+     int i;
+
+     for (i = 1; i < st; ++i)
+	  if (t[i] < tmin)
+	       tmin = t[i];
+
+     probe();
+
+     /* the nominal count if the library did not tell us */
+     flops = p->flops > 0 ? p->flops : mflops(p, 1.0) * 1.0e6;
+     bytes = min_bytes(p);
+     gflops = flops / tmin;
+     gbs = bytes / tmin;
+     attainable = peak_bw * flops / bytes;
+     if (attainable > peak_flops)
+	  attainable = peak_flops;
+
+     sprintf_time(tmin, btmin, 64);
+     ovtpvt("Problem: %s, time: %s, flops: %.6g%s, bytes: %.6g, "
+	    "flop/byte: %.3g\n",
+	    p->pstring, btmin, flops, p->flops > 0 ? "" : " (nominal)",
+	    bytes, flops / bytes);
+     ovtpvt("  GFLOP/s: %.4g (%.1f%% of peak), GB/s: %.4g "
+	    "(%.1f%% of stream), %s-bound, %.1f%% of roofline\n",
+	    gflops * 1.0e-9, 100.0 * gflops / peak_flops,
+	    gbs * 1.0e-9, 100.0 * gbs / peak_bw,
+	    flops / bytes < peak_flops / peak_bw ? "memory" : "compute",
+	    100.0 * gflops / attainable);
+}
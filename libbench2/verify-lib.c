@@ -41,11 +41,11 @@ static double aerror(C *a, C *b, int n)
 	  int i;
 
 	  for (i = 0; i < n; ++i) {
-	       e = dmax(e, norm2(c_re(a[i]) - c_re(b[i]),
-				 c_im(a[i]) - c_im(b[i])));
+	       e = dmax(e, norm2((double) (c_re(a[i]) - c_re(b[i])),
+				 (double) (c_im(a[i]) - c_im(b[i]))));
 	       mag = dmax(mag, 
-			  dmin(norm2(c_re(a[i]), c_im(a[i])),
-			       norm2(c_re(b[i]), c_im(b[i]))));
+			  dmin(norm2((double) c_re(a[i]), (double) c_im(a[i])),
+			       norm2((double) c_re(b[i]), (double) c_im(b[i]))));
 	  }
 	  e /= mag;
 
@@ -49,8 +49,8 @@ static double raerror(R *a, R *b, int n)
           int i;
 
           for (i = 0; i < n; ++i) {
-               e = dmax(e, dabs(a[i] - b[i]));
-               mag = dmax(mag, dmin(dabs(a[i]), dabs(b[i])));
+               e = dmax(e, dabs((double) (a[i] - b[i])));
+               mag = dmax(mag, dmin(dabs((double) a[i]), dabs((double) b[i])));
           }
 	  if (dabs(mag) < 1e-14 && dabs(e) < 1e-14)
 	       e = 0.0;
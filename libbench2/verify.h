@@ -86,15 +86,21 @@ void accuracy_r2r(bench_problem *p, int rounds, int impulse_rounds,
 #  define SIN sinl
 #  define TAN tanl
 #  define KTRIG(x) (x##L)
-#elif defined(BENCHFFT_QUAD) && HAVE_LIBQUADMATH
+#elif (defined(BENCHFFT_QUAD) || defined(BENCHFFT_DDOUBLE)) && HAVE_LIBQUADMATH
    typedef __float128 trigreal;
 #  define COS cosq
 #  define SIN sinq
 #  define TAN tanq
 #  define KTRIG(x) (x##Q)
+#  ifdef __cplusplus
+extern "C" {
+#  endif
 extern trigreal cosq(trigreal);
 extern trigreal sinq(trigreal);
 extern trigreal tanq(trigreal);
+#  ifdef __cplusplus
+}
+#  endif
 #else
    typedef double trigreal;
 #  define COS cos
@@ -138,12 +138,15 @@ void XM(init)(void)
 	  plnr->nowisdom_hook = nowisdom_hook;
 	  plnr->bogosity_hook = bogosity_hook;
           XM(conf_standard)(plnr);
+	  X(destroy_plan_hook) = XM(execute_finish);
 	  mpi_inited = 1;	  
      }
 }
 
 void XM(cleanup)(void)
 {
+     X(destroy_plan_hook) = 0;
+     XM(split_phase_cleanup)();
      X(cleanup)();
      mpi_inited = 0;
 }
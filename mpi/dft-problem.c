@@ -76,6 +76,7 @@ static const problem_adt padt =
 {
      PROBLEM_MPI_DFT,
      hash,
+     0, /* hash_layout */
      zero,
      print,
      destroy
@@ -192,7 +192,11 @@ FFTW_EXTERN void XM(broadcast_wisdom)(MPI_Comm comm_);          \
 FFTW_EXTERN void XM(execute_dft)(X(plan) p, C *in, C *out);	\
 FFTW_EXTERN void XM(execute_dft_r2c)(X(plan) p, R *in, C *out);	\
 FFTW_EXTERN void XM(execute_dft_c2r)(X(plan) p, C *in, R *out);	\
-FFTW_EXTERN void XM(execute_r2r)(X(plan) p, R *in, R *out); 
+FFTW_EXTERN void XM(execute_r2r)(X(plan) p, R *in, R *out);	\
+								\
+FFTW_EXTERN void XM(execute_start)(X(plan) p);			\
+FFTW_EXTERN int XM(execute_test)(X(plan) p);			\
+FFTW_EXTERN void XM(execute_finish)(X(plan) p);
 
 
 
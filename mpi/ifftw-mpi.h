@@ -120,6 +120,11 @@ int XM(md5_equal)(md5 m, MPI_Comm comm);
 /* conf.c */
 void XM(conf_standard)(planner *p);
 
+/* split-phase.c */
+int XM(split_phase)(void);
+void XM(wait_requests)(int n, MPI_Request *reqs);
+void XM(split_phase_cleanup)(void);
+
 /***********************************************************************/
 /* rearrange.c */
 
@@ -258,19 +258,58 @@ static void do_gather_out(bench_real *out)
      }
 }
 
-static void alloc_local(ptrdiff_t nreal, int inplace)
+/* The local arrays of every planned problem.  A plan executes on the
+   arrays it was created for, and replay plans all of its problems
+   before it executes any of them, so each problem keeps its own arrays
+   until plan_done.  local_in and local_out are those of the problem
+   planned last, which is the one being verified. */
+typedef struct local_arrays_s {
+     bench_problem *p;
+     bench_real *in, *out;
+     struct local_arrays_s *cdr;
+} local_arrays;
+static local_arrays *all_arrays = 0;
+
+/* free the local arrays of P, or of all problems if P is null */
+static void free_local(bench_problem *p)
 {
-     bench_free(local_in);
-     if (local_out != local_in) bench_free(local_out);
+     local_arrays **lp = &all_arrays;
+
+     while (*lp) {
+	  local_arrays *l = *lp;
+	  if (!p || l->p == p) {
+	       if (l->in == local_in)
+		    local_in = local_out = 0;
+	       bench_free(l->in);
+	       if (l->out != l->in) bench_free(l->out);
+	       *lp = l->cdr;
+	       bench_free(l);
+	  }
+	  else
+	       lp = &l->cdr;
+     }
+}
+
+static void alloc_local(bench_problem *p, ptrdiff_t nreal, int inplace)
+{
+     free_local(p);
      local_in = local_out = 0;
      if (nreal > 0) {
 	  ptrdiff_t i;
+	  local_arrays *l;
 	  local_in = (bench_real*) bench_malloc(nreal * sizeof(bench_real));
 	  if (inplace)
 	       local_out = local_in;
 	  else
 	       local_out = (bench_real*) bench_malloc(nreal * sizeof(bench_real));
 	  for (i = 0; i < nreal; ++i) local_in[i] = local_out[i] = 0.0;
+
+	  l = (local_arrays *) bench_malloc(sizeof(local_arrays));
+	  l->p = p;
+	  l->in = local_in;
+	  l->out = local_out;
+	  l->cdr = all_arrays;
+	  all_arrays = l;
      }
 }
 
@@ -423,7 +462,7 @@ static FFTW(plan) mkplan_complex(bench_problem *p, unsigned flags)
 	       (total_ni[0], vn, MPI_COMM_WORLD, p->sign, flags,
 		local_ni, local_starti, local_no, local_starto);
      }
-     alloc_local(ntot * 2, p->in == p->out);
+     alloc_local(p, ntot * 2, p->in == p->out);
 
      pln = FFTW(mpi_plan_many_dft)(p->sz->rnk, total_ni, vn, 
 				   FFTW_MPI_DEFAULT_BLOCK,
@@ -506,7 +545,7 @@ static FFTW(plan) mkplan_real(bench_problem *p, unsigned flags)
 	       local_starto[0] = start;
 	  }
      }
-     alloc_local(ntot * 2, p->in == p->out);
+     alloc_local(p, ntot * 2, p->in == p->out);
 
      total_ni[rnk - 1] = p->sz->dims[rnk - 1].n;
      if (p->sign < 0)
@@ -591,7 +630,7 @@ static FFTW(plan) mkplan_transpose(bench_problem *p, unsigned flags)
      local_starto[1] = 0;
      total_ni[0] = nx; total_ni[1] = ny;
      total_no[1] = nx; total_no[0] = ny;
-     alloc_local(ntot, p->in == p->out);
+     alloc_local(p, ntot, p->in == p->out);
 
      pln = FFTW(mpi_plan_many_transpose)(nx, ny, vn,
 					 FFTW_MPI_DEFAULT_BLOCK,
@@ -688,7 +727,7 @@ static FFTW(plan) mkplan_r2r(bench_problem *p, unsigned flags)
 	       (total_ni[0], vn, MPI_COMM_WORLD, p->sign, flags,
 		local_ni, local_starti, local_no, local_starto);
      }
-     alloc_local(ntot, p->in == p->out);
+     alloc_local(p, ntot, p->in == p->out);
 
      k = (FFTW(r2r_kind) *) bench_malloc(sizeof(FFTW(r2r_kind)) * p->sz->rnk);
      for (i = 0; i < p->sz->rnk; ++i)
@@ -763,6 +802,32 @@ FFTW(plan) mkplan(bench_problem *p, unsigned flags)
      return pln;
 }
 
+/* the MPI plans operate on the local arrays of the problem they were
+   planned for, so they cannot be shared between problems */
+void execute_on(FFTW(plan) pln, bench_problem *p)
+{
+     UNUSED(pln); UNUSED(p);
+     BENCH_ASSERT(0 /* not supported */);
+}
+
+/* with the split-phase option, execute as a program that overlaps
+   the exchanges with its own work would: start, poll, then finish */
+void execute_plan(FFTW(plan) pln)
+{
+     if (split_phase) {
+	  FFTW(mpi_execute_start)(pln);
+	  FFTW(mpi_execute_test)(pln);
+	  FFTW(mpi_execute_finish)(pln);
+     }
+     else
+	  FFTW(execute)(pln);
+}
+
+void plan_done(bench_problem *p)
+{
+     free_local(p);
+}
+
 void main_init(int *argc, char ***argv)
 {
 #ifdef HAVE_SMP
@@ -799,7 +864,7 @@ void main_init(int *argc, char ***argv)
 void initial_cleanup(void)
 {
      alloc_rnk(0);
-     alloc_local(0, 0);
+     free_local(0);
      bench_free(all_local_in); all_local_in = 0;
      bench_free(all_local_out); all_local_out = 0;
      bench_free(isend_off); isend_off = 0;
@@ -82,6 +82,7 @@ static const problem_adt padt =
 {
      PROBLEM_MPI_RDFT,
      hash,
+     0, /* hash_layout */
      zero,
      print,
      destroy
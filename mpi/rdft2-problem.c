@@ -80,6 +80,7 @@ static const problem_adt padt =
 {
      PROBLEM_MPI_RDFT2,
      hash,
+     0, /* hash_layout */
      zero,
      print,
      destroy
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* Split-phase execution: XM(execute_start) returns as soon as the
+   plan is waiting for communication, XM(execute_test) advances it if
+   the communication has completed, and XM(execute_finish) runs it to
+   the end, so that the caller can compute in the meantime.
+
+   Rather than rewriting every MPI solver as an explicit state
+   machine, each execution runs the ordinary apply() functions on a
+   stack of its own (a coroutine).  The only points where it can be
+   suspended are the calls to XM(wait_requests) in the transposes,
+   which give back control to the caller together with the requests
+   that must complete before the execution can be resumed.  Thus the
+   local transforms between two exchanges run inside whichever of
+   start/test/finish finds the previous exchange complete.
+
+   An execution still in flight when its plan is destroyed is run to
+   completion first (X(destroy_plan_hook), set by XM(init)), so that
+   no stale entry can match a later plan at the same address.
+
+   Without <ucontext.h>, XM(execute_start) simply executes the plan. */
+
+#include "api.h"
+#include "fftw3-mpi.h"
+#include "ifftw-mpi.h"
+
+#if defined(HAVE_UCONTEXT_H) && defined(HAVE_SWAPCONTEXT)
+#  define SPLIT_PHASE 1
+#  include <ucontext.h>
+#  if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#    define GUARD_PAGE 1
+#    include <sys/mman.h>
+#    ifdef HAVE_UNISTD_H
+#      include <unistd.h>
+#    endif
+#    ifndef MAP_ANONYMOUS
+#      define MAP_ANONYMOUS MAP_ANON
+#    endif
+#  endif
+#endif
+
+#ifdef SPLIT_PHASE
+
+/* plenty for the STACK_MALLOC buffers of a few nested plans; pages
+   that are never touched are never committed */
+#define STACK_SIZE ((size_t) 4 << 20)
+
+typedef struct execution_s {
+     X(plan) p;
+     int done;
+     int nreqs;
+     MPI_Request *reqs; /* what the suspended execution waits for */
+     ucontext_t caller, self;
+     char *stack; /* STACK_SIZE bytes, above the guard page if any */
+     struct execution_s *cdr;
+} execution;
+
+static execution *executions = 0; /* started and not yet finished */
+static execution *spare = 0; /* finished, with their stacks */
+static execution *current = 0; /* the one running, if any */
+
+static execution *lookup(const X(plan) p)
+{
+     execution *e;
+     for (e = executions; e; e = e->cdr)
+	  if (e->p == p)
+	       return e;
+     return 0;
+}
+
+static void run(void)
+{
+     execution *e = current;
+     X(execute)(e->p);
+     e->done = 1;
+     /* return to e->caller through uc_link */
+}
+
+static void resume(execution *e)
+{
+     A(!current);
+     current = e;
+     swapcontext(&e->caller, &e->self);
+     current = 0;
+}
+
+#ifdef GUARD_PAGE
+static size_t guard_size(void)
+{
+#  ifdef _SC_PAGESIZE
+     long p = sysconf(_SC_PAGESIZE);
+     if (p > 0)
+	  return (size_t) p;
+#  endif
+     return 4096;
+}
+#endif
+
+/* the stack grows down, so an overflow runs into an inaccessible page
+   below it instead of into whatever malloc put there */
+static char *stack_alloc(void)
+{
+#ifdef GUARD_PAGE
+     size_t g = guard_size();
+     void *p = mmap(0, g + STACK_SIZE, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+     if (p != MAP_FAILED) {
+	  if (!mprotect(p, g, PROT_NONE))
+	       return (char *) p + g;
+	  munmap(p, g + STACK_SIZE);
+     }
+     return 0;
+#else
+     return (char *) MALLOC(STACK_SIZE, OTHER);
+#endif
+}
+
+static void stack_free(char *stack)
+{
+#ifdef GUARD_PAGE
+     size_t g = guard_size();
+     munmap(stack - g, g + STACK_SIZE);
+#else
+     X(ifree)(stack);
+#endif
+}
+
+static void release(execution *e)
+{
+     execution **ep;
+     for (ep = &executions; *ep != e; ep = &(*ep)->cdr)
+	  ;
+     *ep = e->cdr;
+     e->cdr = spare;
+     spare = e;
+}
+
+int XM(split_phase)(void)
+{
+     return current != 0;
+}
+
+void XM(wait_requests)(int n, MPI_Request *reqs)
+{
+     execution *e = current;
+
+     if (e) {
+	  e->nreqs = n;
+	  e->reqs = reqs;
+	  swapcontext(&e->self, &e->caller);
+	  /* resumed once the requests have completed */
+     }
+     else
+	  MPI_Waitall(n, reqs, MPI_STATUSES_IGNORE);
+}
+
+void XM(execute_start)(X(plan) p)
+{
+     execution *e;
+
+     XM(execute_finish)(p); /* one execution of P at a time */
+
+     if ((e = spare))
+	  spare = e->cdr;
+     else {
+	  char *stack = stack_alloc();
+	  if (!stack) {		/* no stack: execute in one phase */
+	       X(execute)(p);
+	       return;
+	  }
+	  e = (execution *) MALLOC(sizeof(execution), OTHER);
+	  e->stack = stack;
+     }
+     e->p = p;
+     e->done = 0;
+     e->nreqs = 0;
+     e->reqs = 0;
+     e->cdr = executions;
+     executions = e;
+
+     getcontext(&e->self);
+     e->self.uc_stack.ss_sp = e->stack;
+     e->self.uc_stack.ss_size = STACK_SIZE;
+     e->self.uc_link = &e->caller;
+     makecontext(&e->self, run, 0);
+     resume(e);
+     if (e->done)
+	  release(e);
+}
+
+int XM(execute_test)(X(plan) p)
+{
+     execution *e = lookup(p);
+     int flag = 1;
+
+     if (!e)
+	  return 1;
+     if (e->nreqs)
+	  MPI_Testall(e->nreqs, e->reqs, &flag, MPI_STATUSES_IGNORE);
+     if (!flag)
+	  return 0;
+     e->nreqs = 0;
+     resume(e);
+     if (!e->done)
+	  return 0;
+     release(e);
+     return 1;
+}
+
+void XM(execute_finish)(X(plan) p)
+{
+     execution *e = lookup(p);
+
+     if (!e)
+	  return;
+     while (!e->done) {
+	  if (e->nreqs)
+	       MPI_Waitall(e->nreqs, e->reqs, MPI_STATUSES_IGNORE);
+	  e->nreqs = 0;
+	  resume(e);
+     }
+     release(e);
+}
+
+void XM(split_phase_cleanup)(void)
+{
+     execution *e;
+     while ((e = spare)) {
+	  spare = e->cdr;
+	  stack_free(e->stack);
+	  X(ifree)(e);
+     }
+}
+
+#else /* !SPLIT_PHASE */
+
+int XM(split_phase)(void)
+{
+     return 0;
+}
+
+void XM(wait_requests)(int n, MPI_Request *reqs)
+{
+     MPI_Waitall(n, reqs, MPI_STATUSES_IGNORE);
+}
+
+void XM(execute_start)(X(plan) p)
+{
+     X(execute)(p);
+}
+
+int XM(execute_test)(X(plan) p)
+{
+     UNUSED(p);
+     return 1;
+}
+
+void XM(execute_finish)(X(plan) p)
+{
+     UNUSED(p);
+}
+
+void XM(split_phase_cleanup)(void)
+{
+}
+
+#endif
@@ -46,6 +46,39 @@ typedef struct {
      int equal_blocks;
 } P;
 
+/* transpose chunks globally, from I to O */
+static void alltoall(const P *ego, R *I, R *O)
+{
+#if MPI_VERSION >= 3
+     if (XM(split_phase)()) {
+	  /* let XM(execute_start) return while the exchange is in flight */
+	  MPI_Request req;
+	  if (ego->equal_blocks)
+	       MPI_Ialltoall(I, ego->send_block_sizes[0], FFTW_MPI_TYPE,
+			     O, ego->recv_block_sizes[0], FFTW_MPI_TYPE,
+			     ego->comm, &req);
+	  else
+	       MPI_Ialltoallv(I, ego->send_block_sizes, ego->send_block_offsets,
+			      FFTW_MPI_TYPE,
+			      O, ego->recv_block_sizes, ego->recv_block_offsets,
+			      FFTW_MPI_TYPE,
+			      ego->comm, &req);
+	  XM(wait_requests)(1, &req);
+	  return;
+     }
+#endif
+     if (ego->equal_blocks)
+	  MPI_Alltoall(I, ego->send_block_sizes[0], FFTW_MPI_TYPE,
+		       O, ego->recv_block_sizes[0], FFTW_MPI_TYPE,
+		       ego->comm);
+     else
+	  MPI_Alltoallv(I, ego->send_block_sizes, ego->send_block_offsets,
+			FFTW_MPI_TYPE,
+			O, ego->recv_block_sizes, ego->recv_block_offsets,
+			FFTW_MPI_TYPE,
+			ego->comm);
+}
+
 static void apply(const plan *ego_, R *I, R *O)
 {
      const P *ego = (const P *) ego_;
@@ -57,29 +90,11 @@ static void apply(const plan *ego_, R *I, R *O)
 	  cld1->apply(ego->cld1, I, O);
 	  
 	  /* transpose chunks globally */
-	  if (ego->equal_blocks)
-	       MPI_Alltoall(O, ego->send_block_sizes[0], FFTW_MPI_TYPE,
-			    I, ego->recv_block_sizes[0], FFTW_MPI_TYPE,
-			    ego->comm);
-	  else
-	       MPI_Alltoallv(O, ego->send_block_sizes, ego->send_block_offsets,
-			     FFTW_MPI_TYPE,
-			     I, ego->recv_block_sizes, ego->recv_block_offsets,
-			     FFTW_MPI_TYPE,
-			     ego->comm);
+	  alltoall(ego, O, I);
      }
      else { /* TRANSPOSED_IN, no need to destroy input */
 	  /* transpose chunks globally */
-	  if (ego->equal_blocks)
-	       MPI_Alltoall(I, ego->send_block_sizes[0], FFTW_MPI_TYPE,
-			    O, ego->recv_block_sizes[0], FFTW_MPI_TYPE,
-			    ego->comm);
-	  else
-	       MPI_Alltoallv(I, ego->send_block_sizes, ego->send_block_offsets,
-			     FFTW_MPI_TYPE,
-			     O, ego->recv_block_sizes, ego->recv_block_offsets,
-			     FFTW_MPI_TYPE,
-			     ego->comm);
+	  alltoall(ego, I, O);
 	  I = O; /* final transpose (if any) is in-place */
      }
      
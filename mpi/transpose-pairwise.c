@@ -44,6 +44,12 @@ typedef struct {
      INT *recv_block_sizes, *recv_block_offsets;
      MPI_Comm comm;
      int preserve_input;
+
+     /* persistent sends and receives for the arrays that the plan was
+	made for, while the plan is awake, see mkreqs() */
+     R *req_I, *req_O, *buf;
+     MPI_Request *reqs;
+     int nreqs;
 } P;
 
 static void transpose_chunks(int *sched, int n_pes, int my_pe,
@@ -98,6 +104,53 @@ static void transpose_chunks(int *sched, int n_pes, int my_pe,
      }
 }
 
+/* Same as transpose_chunks, with the persistent requests of the plan.
+   Out of place, all the exchanges are started at once, and the local
+   copy overlaps with them.  In place, the exchanges must still follow
+   the schedule, since a block is only received after the block that
+   it overwrites has been sent; each receive is paired with a send from
+   BUF as above. */
+static void transpose_chunks_persistent(const P *ego, R *I, R *O)
+{
+     int i, k, my_pe = ego->my_pe;
+     int *sched = ego->sched;
+     INT *sbs = ego->send_block_sizes, *sbo = ego->send_block_offsets;
+     INT *rbo = ego->recv_block_offsets;
+
+     if (I == O) {
+	  for (i = k = 0; i < ego->n_pes; ++i) {
+	       int pe = sched[i];
+	       if (my_pe == pe) {
+		    if (rbo[pe] != sbo[pe])
+			 memmove(O + rbo[pe], O + sbo[pe],
+				 sbs[pe] * sizeof(R));
+	       }
+	       else {
+		    memcpy(ego->buf, O + sbo[pe], sbs[pe] * sizeof(R));
+		    MPI_Startall(2, ego->reqs + k);
+		    XM(wait_requests)(2, ego->reqs + k);
+		    k += 2;
+	       }
+	  }
+     }
+     else { /* I != O */
+	  MPI_Startall(ego->nreqs, ego->reqs);
+	  memcpy(O + rbo[my_pe], I + sbo[my_pe], sbs[my_pe] * sizeof(R));
+	  XM(wait_requests)(ego->nreqs, ego->reqs);
+     }
+}
+
+static void exchange(const P *ego, R *I, R *O)
+{
+     if (ego->reqs && I == ego->req_I && O == ego->req_O)
+	  transpose_chunks_persistent(ego, I, O);
+     else
+	  transpose_chunks(ego->sched, ego->n_pes, ego->my_pe,
+			   ego->send_block_sizes, ego->send_block_offsets,
+			   ego->recv_block_sizes, ego->recv_block_offsets,
+			   ego->comm, I, O);
+}
+
 static void apply(const plan *ego_, R *I, R *O)
 {
      const P *ego = (const P *) ego_;
@@ -111,26 +164,17 @@ static void apply(const plan *ego_, R *I, R *O)
 	  if (ego->preserve_input) I = O;
 
 	  /* transpose chunks globally */
-	  transpose_chunks(ego->sched, ego->n_pes, ego->my_pe,
-			   ego->send_block_sizes, ego->send_block_offsets,
-			   ego->recv_block_sizes, ego->recv_block_offsets,
-			   ego->comm, O, I);
+	  exchange(ego, O, I);
      }
      else if (ego->preserve_input) {
 	  /* transpose chunks globally */
-	  transpose_chunks(ego->sched, ego->n_pes, ego->my_pe,
-			   ego->send_block_sizes, ego->send_block_offsets,
-			   ego->recv_block_sizes, ego->recv_block_offsets,
-			   ego->comm, I, O);
+	  exchange(ego, I, O);
 
 	  I = O;
      }
      else {
 	  /* transpose chunks globally */
-	  transpose_chunks(ego->sched, ego->n_pes, ego->my_pe,
-			   ego->send_block_sizes, ego->send_block_offsets,
-			   ego->recv_block_sizes, ego->recv_block_offsets,
-			   ego->comm, I, I);
+	  exchange(ego, I, I);
      }
 
      /* transpose locally, again, to get ordinary row-major;
@@ -162,6 +206,75 @@ static int applicable(const S *ego, const problem *p_,
 	     && ONLY_TRANSPOSEDP(p->flags));
 }
 
+/* Set up persistent requests for the exchange from REQ_I to REQ_O
+   that apply() performs for the arrays of the problem, so that the
+   arguments are checked and the peers are looked up once, when the
+   plan is awakened, and not at every execution (which, for
+   time-stepping codes, may be millions of times).  Candidate plans
+   that the planner builds and throws away without executing them
+   never get any.  Other arrays (new-array execute) fall back to
+   transpose_chunks.  Since persistent point-to-point requests match
+   ordinary ones, this is correct even if other processes take the
+   fallback. */
+static void mkreqs(P *pln)
+{
+     int i, k, pe, my_pe = pln->my_pe, n_pes = pln->n_pes;
+     INT *sbs = pln->send_block_sizes, *sbo = pln->send_block_offsets;
+     INT *rbs = pln->recv_block_sizes, *rbo = pln->recv_block_offsets;
+     INT bufsz = 0;
+     R *I = pln->req_I, *O = pln->req_O;
+
+     if (pln->reqs || !pln->sched || n_pes < 2)
+	  return;
+
+     pln->nreqs = 2 * (n_pes - 1);
+     pln->reqs = (MPI_Request *) MALLOC(pln->nreqs * sizeof(MPI_Request),
+					PLANS);
+     if (I == O) {
+	  for (pe = 0; pe < n_pes; ++pe)
+	       if (pe != my_pe)
+		    bufsz = X(imax)(bufsz, sbs[pe]);
+	  pln->buf = (R *) MALLOC(sizeof(R) * bufsz, BUFFERS);
+     }
+
+     /* in place, a send/receive pair per step of the schedule;
+	out of place, all the receives first and then all the sends */
+     for (i = k = 0; i < n_pes; ++i) {
+	  pe = pln->sched[i];
+	  if (pe == my_pe) continue;
+	  if (I == O) {
+	       MPI_Recv_init(O + rbo[pe], (int) (rbs[pe]), FFTW_MPI_TYPE,
+			     pe, (pe * n_pes + my_pe) & 0xffff,
+			     pln->comm, pln->reqs + k);
+	       MPI_Send_init(pln->buf, (int) (sbs[pe]), FFTW_MPI_TYPE,
+			     pe, (my_pe * n_pes + pe) & 0xffff,
+			     pln->comm, pln->reqs + k + 1);
+	       k += 2;
+	  }
+	  else {
+	       MPI_Recv_init(O + rbo[pe], (int) (rbs[pe]), FFTW_MPI_TYPE,
+			     pe, (pe * n_pes + my_pe) & 0xffff,
+			     pln->comm, pln->reqs + k);
+	       MPI_Send_init(I + sbo[pe], (int) (sbs[pe]), FFTW_MPI_TYPE,
+			     pe, (my_pe * n_pes + pe) & 0xffff,
+			     pln->comm, pln->reqs + k + n_pes - 1);
+	       k += 1;
+	  }
+     }
+}
+
+static void freereqs(P *pln)
+{
+     int i;
+     for (i = 0; i < pln->nreqs; ++i)
+	  MPI_Request_free(pln->reqs + i);
+     X(ifree0)(pln->reqs);
+     X(ifree0)(pln->buf);
+     pln->reqs = 0;
+     pln->nreqs = 0;
+     pln->buf = 0;
+}
+
 static void awake(plan *ego_, enum wakefulness wakefulness)
 {
      P *ego = (P *) ego_;
@@ -169,11 +282,17 @@ static void awake(plan *ego_, enum wakefulness wakefulness)
      X(plan_awake)(ego->cld2, wakefulness);
      X(plan_awake)(ego->cld2rest, wakefulness);
      X(plan_awake)(ego->cld3, wakefulness);
+
+     if (wakefulness == SLEEPY)
+	  freereqs(ego);
+     else
+	  mkreqs(ego);
 }
 
 static void destroy(plan *ego_)
 {
      P *ego = (P *) ego_;
+     freereqs(ego);
      X(ifree0)(ego->sched);
      X(ifree0)(ego->send_block_sizes);
      MPI_Comm_free(&ego->comm);
@@ -453,6 +572,20 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
 	       sort1_comm_sched(pln->sched, n_pes, sort_pe, ascending);
      }
 
+     /* the arrays of the exchange in apply(); the requests are made
+	by awake() */
+     if (cld1) {
+	  pln->req_I = p->O;
+	  pln->req_O = pln->preserve_input ? p->O : p->I;
+     } else if (pln->preserve_input) {
+	  pln->req_I = p->I;
+	  pln->req_O = p->O;
+     } else
+	  pln->req_I = pln->req_O = p->I;
+     pln->buf = 0;
+     pln->reqs = 0;
+     pln->nreqs = 0;
+
      X(ops_zero)(&pln->super.super.ops);
      if (cld1) X(ops_add2)(&cld1->ops, &pln->super.super.ops);
      if (cld2) X(ops_add2)(&cld2->ops, &pln->super.super.ops);
@@ -79,6 +79,7 @@ static const problem_adt padt =
 {
      PROBLEM_MPI_TRANSPOSE,
      hash,
+     0, /* hash_layout */
      zero,
      print,
      destroy
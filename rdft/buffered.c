@@ -19,19 +19,30 @@
  */
 
 
+/* Transforms of a vector of lines through a buffer of NBUF lines;
+   with TILED, a tile of adjacent lines along a strided axis is
+   gathered into the buffer and transformed there.  See
+   dft/buffered.c. */
+
 #include "rdft.h"
 
 typedef struct {
      solver super;
      int maxnbuf_ndx;
+     int tiled;
 } S;
 
 static const INT maxnbufs[] = { 8, 256 };
 
+/* bytes per tile for the tiled solvers, roughly an L1 and an L2
+   cache; one for each element of MAXNBUFS */
+static const INT tilebytes[] = { 32 * 1024, 256 * 1024 };
+
 typedef struct {
      plan_rdft super;
 
      plan *cld, *cldcpy, *cldrest;
+     plan *cldgather;		/* tiled only */
      INT n, vl, nbuf, bufdist;
      INT ivs_by_nbuf, ovs_by_nbuf;
 } P;
@@ -98,11 +109,42 @@ static void apply_hc2r(const plan *ego_, R *I, R *O)
      cldrest->apply((plan *) cldrest, I, O);
 }
 
+/* gather a tile into bufs, transform it there, and copy it back */
+static void apply_tiled(const plan *ego_, R *I, R *O)
+{
+     const P *ego = (const P *) ego_;
+     plan_rdft *cldgather = (plan_rdft *) ego->cldgather;
+     plan_rdft *cld = (plan_rdft *) ego->cld;
+     plan_rdft *cldcpy = (plan_rdft *) ego->cldcpy;
+     plan_rdft *cldrest;
+     INT i, vl = ego->vl, nbuf = ego->nbuf;
+     INT ivs_by_nbuf = ego->ivs_by_nbuf, ovs_by_nbuf = ego->ovs_by_nbuf;
+     R *bufs;
+
+     bufs = (R *)MALLOC(sizeof(R) * nbuf * ego->bufdist, BUFFERS);
+
+     for (i = nbuf; i <= vl; i += nbuf) {
+	  cldgather->apply((plan *) cldgather, I, bufs);
+	  I += ivs_by_nbuf;
+
+	  cld->apply((plan *) cld, bufs, bufs);
+
+	  cldcpy->apply((plan *) cldcpy, bufs, O);
+	  O += ovs_by_nbuf;
+     }
+
+     X(ifree)(bufs);
+
+     /* Do the remaining transforms, if any: */
+     cldrest = (plan_rdft *) ego->cldrest;
+     cldrest->apply((plan *) cldrest, I, O);
+}
 
 static void awake(plan *ego_, enum wakefulness wakefulness)
 {
      P *ego = (P *) ego_;
 
+     X(plan_awake)(ego->cldgather, wakefulness);
      X(plan_awake)(ego->cld, wakefulness);
      X(plan_awake)(ego->cldcpy, wakefulness);
      X(plan_awake)(ego->cldrest, wakefulness);
@@ -114,15 +156,31 @@ static void destroy(plan *ego_)
      X(plan_destroy_internal)(ego->cldrest);
      X(plan_destroy_internal)(ego->cldcpy);
      X(plan_destroy_internal)(ego->cld);
+     X(plan_destroy_internal)(ego->cldgather);
 }
 
 static void print(const plan *ego_, printer *p)
 {
      const P *ego = (const P *) ego_;
-     p->print(p, "(rdft-buffered-%D%v/%D-%D%(%p%)%(%p%)%(%p%))",
-              ego->n, ego->nbuf,
-              ego->vl, ego->bufdist % ego->n,
-              ego->cld, ego->cldcpy, ego->cldrest);
+     if (ego->cldgather)
+	  p->print(p, "(rdft-buffered-tiled-%D%v/%D-%D%(%p%)%(%p%)%(%p%)%(%p%))",
+		   ego->n, ego->nbuf,
+		   ego->vl, ego->bufdist % ego->n,
+		   ego->cldgather, ego->cld, ego->cldcpy, ego->cldrest);
+     else
+	  p->print(p, "(rdft-buffered-%D%v/%D-%D%(%p%)%(%p%)%(%p%))",
+		   ego->n, ego->nbuf,
+		   ego->vl, ego->bufdist % ego->n,
+		   ego->cld, ego->cldcpy, ego->cldrest);
+}
+
+/* the maximum number of buffers of solver NDX of EGO's kind, for
+   lines of size N */
+static INT maxnbuf(const S *ego, int ndx, INT n)
+{
+     if (ego->tiled)
+	  return X(imax)(1, tilebytes[ndx] / (n * (INT) sizeof(R)));
+     return maxnbufs[ndx];
 }
 
 static int applicable0(const S *ego, const problem *p_, const planner *plnr)
@@ -134,7 +192,8 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	 && p->vecsz->rnk <= 1
 	 && p->sz->rnk == 1
 	  ) {
-	  INT vl, ivs, ovs;
+	  INT vl, ivs, ovs, mnb[NELEM(maxnbufs)];
+	  int i;
 	  X(tensor_tornk1)(p->vecsz, &vl, &ivs, &ovs);
 
 	  if (X(toobig)(d[0].n) && CONSERVE_MEMORYP(plnr))
@@ -143,12 +202,25 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	  /* if this solver is redundant, in the sense that a solver
 	     of lower index generates the same plan, then prune this
 	     solver */
+	  for (i = 0; i < (int) NELEM(maxnbufs); ++i)
+	       mnb[i] = maxnbuf(ego, i, d[0].n);
 	  if (X(nbuf_redundant)(d[0].n, vl,
 				ego->maxnbuf_ndx,
-				maxnbufs, NELEM(maxnbufs)))
+				mnb, NELEM(maxnbufs)))
 	       return 0;
 
-	  if (p->I != p->O) {
+	  if (ego->tiled) {
+	       /* the lines are adjacent, and the transform is strided */
+	       if (!(1
+		     && p->vecsz->rnk == 1
+		     && vl > 1
+		     && X(iabs)(ivs) < X(iabs)(d[0].is)
+		     && X(iabs)(ovs) < X(iabs)(d[0].os)))
+		    return 0;
+
+	       if (p->I != p->O)
+		    return 1;
+	  } else if (p->I != p->O) {
 	       if (p->kind[0] == HC2R) {
 		    /* Allow HC2R problems only if the input is to be
 		       preserved.  This solver sets NO_DESTROY_INPUT,
@@ -177,7 +249,7 @@ static int applicable0(const S *ego, const problem *p_, const planner *plnr)
 	       ((p->vecsz->rnk == 0)
 		||
 		(X(nbuf)(d[0].n, p->vecsz->dims[0].n, 
-			 maxnbufs[ego->maxnbuf_ndx]) 
+			 mnb[ego->maxnbuf_ndx]) 
 		 == p->vecsz->dims[0].n)))
 	       return 1;
      }
@@ -192,6 +264,7 @@ static int applicable(const S *ego, const problem *p_, const planner *plnr)
      if (NO_BUFFERINGP(plnr)) return 0;
 
      if (!applicable0(ego, p_, plnr)) return 0;
+     if (ego->tiled) return 1;
 
      p = (const problem_rdft *) p_;
      if (p->kind[0] == HC2R) {
@@ -217,6 +290,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      plan *cld = (plan *) 0;
      plan *cldcpy = (plan *) 0;
      plan *cldrest = (plan *) 0;
+     plan *cldgather = (plan *) 0;
      const problem_rdft *p = (const problem_rdft *) p_;
      R *bufs = (R *) 0;
      INT nbuf = 0, bufdist, n, vl;
@@ -234,14 +308,36 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      X(tensor_tornk1)(p->vecsz, &vl, &ivs, &ovs);
      hc2rp = (p->kind[0] == HC2R);
 
-     nbuf = X(nbuf)(n, vl, maxnbufs[ego->maxnbuf_ndx]);
+     nbuf = X(nbuf)(n, vl, maxnbuf(ego, ego->maxnbuf_ndx, n));
      bufdist = X(bufdist)(n, vl);
      A(nbuf > 0);
 
      /* initial allocation for the purpose of planning */
      bufs = (R *) MALLOC(sizeof(R) * nbuf * bufdist, BUFFERS);
 
-     if (hc2rp) {
+     if (ego->tiled) {
+	  /* gathering the tile is a rank-0 transform (a transposition) */
+	  cldgather = X(mkplan_d)(plnr,
+				  X(mkproblem_rdft_0_d)(
+				       X(mktensor_2d)(nbuf, ivs, bufdist,
+						      n, p->sz->dims[0].is, 1),
+				       TAINT(p->I, ivs * nbuf), bufs));
+	  if (!cldgather) goto nada;
+
+	  cld = X(mkplan_d)(plnr,
+			    X(mkproblem_rdft_d)(
+				 X(mktensor_1d)(n, 1, 1),
+				 X(mktensor_1d)(nbuf, bufdist, bufdist),
+				 bufs, bufs, p->kind));
+	  if (!cld) goto nada;
+
+	  cldcpy = X(mkplan_d)(plnr, 
+			       X(mkproblem_rdft_0_d)(
+				    X(mktensor_2d)(nbuf, bufdist, ovs,
+						   n, 1, p->sz->dims[0].os),
+				    bufs, TAINT(p->O, ovs * nbuf)));
+	  if (!cldcpy) goto nada;
+     } else if (hc2rp) {
 	  /* allow destruction of buffer */
 	  cld = X(mkplan_f_d)(plnr, 
 			      X(mkproblem_rdft_d)(
@@ -293,7 +389,9 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      }
      if (!cldrest) goto nada;
 
-     pln = MKPLAN_RDFT(P, &padt, hc2rp ? apply_hc2r : apply);
+     pln = MKPLAN_RDFT(P, &padt,
+		       cldgather ? apply_tiled : (hc2rp ? apply_hc2r : apply));
+     pln->cldgather = cldgather;
      pln->cld = cld;
      pln->cldcpy = cldcpy;
      pln->cldrest = cldrest;
@@ -308,6 +406,8 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      {
 	  opcnt t;
 	  X(ops_add)(&cld->ops, &cldcpy->ops, &t);
+	  if (cldgather)
+	       X(ops_add2)(&cldgather->ops, &t);
 	  X(ops_madd)(vl / nbuf, &t, &cldrest->ops, &pln->super.super.ops);
      }
 
@@ -318,14 +418,16 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      X(plan_destroy_internal)(cldrest);
      X(plan_destroy_internal)(cldcpy);
      X(plan_destroy_internal)(cld);
+     X(plan_destroy_internal)(cldgather);
      return (plan *) 0;
 }
 
-static solver *mksolver(int maxnbuf_ndx)
+static solver *mksolver(int maxnbuf_ndx, int tiled)
 {
      static const solver_adt sadt = { PROBLEM_RDFT, mkplan, 0 };
      S *slv = MKSOLVER(S, &sadt);
      slv->maxnbuf_ndx = maxnbuf_ndx;
+     slv->tiled = tiled;
      return &(slv->super);
 }
 
@@ -333,5 +435,7 @@ void X(rdft_buffered_register)(planner *p)
 {
      size_t i;
      for (i = 0; i < NELEM(maxnbufs); ++i)
-	  REGISTER_SOLVER(p, mksolver(i));
+	  REGISTER_SOLVER(p, mksolver(i, 0));
+     for (i = 0; i < NELEM(tilebytes); ++i)
+	  REGISTER_SOLVER(p, mksolver(i, 1));
 }
@@ -31,8 +31,10 @@ typedef struct {
 typedef struct {
      plan_hc2c super;
      khc2c k;
-     plan *cld0, *cldm; /* children for 0th and middle butterflies */
+     plan *cld0, *cldm; /* children for 0th and middle butterflies,
+			   if they are in the range of the plan */
      INT r, m, v, extra_iter;
+     INT mb, me;        /* range of the codelet butterflies */
      INT ms, vs;
      stride rs, brs;
      twid *td;
@@ -49,13 +51,16 @@ static void apply(const plan *ego_, R *cr, R *ci)
      plan_rdft2 *cldm = (plan_rdft2 *) ego->cldm;
      INT i, m = ego->m, v = ego->v;
      INT ms = ego->ms, vs = ego->vs;
+     INT mb = ego->mb, me = ego->me;
 
      for (i = 0; i < v; ++i, cr += vs, ci += vs) {
-	  cld0->apply((plan *) cld0, cr, ci, cr, ci);
-	  ego->k(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-		 ego->td->W, ego->rs, 1, (m+1)/2, ms);
-	  cldm->apply((plan *) cldm, cr + (m/2)*ms, ci + (m/2)*ms, 
-		      cr + (m/2)*ms, ci + (m/2)*ms);
+	  if (cld0)
+	       cld0->apply((plan *) cld0, cr, ci, cr, ci);
+	  ego->k(cr + mb*ms, ci + mb*ms, cr + (m-mb)*ms, ci + (m-mb)*ms,
+		 ego->td->W, ego->rs, mb, me, ms);
+	  if (cldm)
+	       cldm->apply((plan *) cldm, cr + (m/2)*ms, ci + (m/2)*ms, 
+			   cr + (m/2)*ms, ci + (m/2)*ms);
      }
 }
 
@@ -66,10 +71,11 @@ static void apply_extra_iter(const plan *ego_, R *cr, R *ci)
      plan_rdft2 *cldm = (plan_rdft2 *) ego->cldm;
      INT i, m = ego->m, v = ego->v;
      INT ms = ego->ms, vs = ego->vs;
-     INT mm = (m-1)/2;
+     INT mb = ego->mb, mm = ego->me - 1;
 
      for (i = 0; i < v; ++i, cr += vs, ci += vs) {
-	  cld0->apply((plan *) cld0, cr, ci, cr, ci);
+	  if (cld0)
+	       cld0->apply((plan *) cld0, cr, ci, cr, ci);
 
 	  /* for 4-way SIMD when (m+1)/2-1 is odd: iterate over an
 	     even vector length MM-1, and then execute the last
@@ -77,12 +83,13 @@ static void apply_extra_iter(const plan *ego_, R *cr, R *ci)
 	     twiddle factors of the second half of the last iteration
 	     are bogus, but we only store the results of the first
 	     half. */
-	  ego->k(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-		 ego->td->W, ego->rs, 1, mm, ms);
+	  ego->k(cr + mb*ms, ci + mb*ms, cr + (m-mb)*ms, ci + (m-mb)*ms,
+		 ego->td->W, ego->rs, mb, mm, ms);
 	  ego->k(cr + mm*ms, ci + mm*ms, cr + (m-mm)*ms, ci + (m-mm)*ms,
 		 ego->td->W, ego->rs, mm, mm+2, 0);
-	  cldm->apply((plan *) cldm, cr + (m/2)*ms, ci + (m/2)*ms, 
-		      cr + (m/2)*ms, ci + (m/2)*ms);
+	  if (cldm)
+	       cldm->apply((plan *) cldm, cr + (m/2)*ms, ci + (m/2)*ms, 
+			   cr + (m/2)*ms, ci + (m/2)*ms);
      }
 
 }
@@ -133,7 +140,7 @@ static void apply_buf(const plan *ego_, R *cr, R *ci)
      INT i, j, ms = ego->ms, v = ego->v;
      INT batchsz = compute_batchsize(ego->r);
      R *buf;
-     INT mb = 1, me = (ego->m+1) / 2;
+     INT mb = ego->mb, me = ego->me, mid = (ego->m / 2) * ms;
      size_t bufsz = ego->r * batchsz * 2 * sizeof(R);
 
      BUF_ALLOC(R *, buf, bufsz);
@@ -144,16 +151,17 @@ static void apply_buf(const plan *ego_, R *cr, R *ci)
 	  R *Rm = cr + ego->m * ms;
 	  R *Im = ci + ego->m * ms;
 
-	  cld0->apply((plan *) cld0, Rp, Ip, Rp, Ip);
+	  if (cld0)
+	       cld0->apply((plan *) cld0, Rp, Ip, Rp, Ip);
 
 	  for (j = mb; j + batchsz < me; j += batchsz) 
 	       dobatch(ego, Rp, Ip, Rm, Im, j, j + batchsz, 0, buf);
 
 	  dobatch(ego, Rp, Ip, Rm, Im, j, me, ego->extra_iter, buf);
 
-	  cldm->apply((plan *) cldm, 
-		      Rp + me * ms, Ip + me * ms,
-		      Rp + me * ms, Ip + me * ms);
+	  if (cldm)
+	       cldm->apply((plan *) cldm, 
+			   Rp + mid, Ip + mid, Rp + mid, Ip + mid);
 
      }
 
@@ -190,15 +198,15 @@ static void print(const plan *ego_, printer *p)
      const hc2c_desc *e = slv->desc;
 
      if (slv->bufferedp)
-	  p->print(p, "(hc2c-directbuf/%D-%D/%D/%D%v \"%s\"%(%p%)%(%p%))",
+	  p->print(p, "(hc2c-directbuf/%D-%D/%D/%D%v/%D-%D \"%s\"%(%p%)%(%p%))",
 		   compute_batchsize(ego->r),
 		   ego->r, X(twiddle_length)(ego->r, e->tw),
-		   ego->extra_iter, ego->v, e->nam, 
+		   ego->extra_iter, ego->v, ego->mb, ego->me, e->nam, 
 		   ego->cld0, ego->cldm);
      else
-	  p->print(p, "(hc2c-direct-%D/%D/%D%v \"%s\"%(%p%)%(%p%))",
+	  p->print(p, "(hc2c-direct-%D/%D/%D%v/%D-%D \"%s\"%(%p%)%(%p%))",
 		   ego->r, X(twiddle_length)(ego->r, e->tw), 
-		   ego->extra_iter, ego->v, e->nam, 
+		   ego->extra_iter, ego->v, ego->mb, ego->me, e->nam, 
 		   ego->cld0, ego->cldm);
 }
 
@@ -206,6 +214,7 @@ static int applicable0(const S *ego, rdft_kind kind,
 		       INT r, INT rs,
 		       INT m, INT ms, 
 		       INT v, INT vs,
+		       INT mb, INT me,
 		       const R *cr, const R *ci,
 		       const planner *plnr,
 		       INT *extra_iter)
@@ -213,6 +222,9 @@ static int applicable0(const S *ego, rdft_kind kind,
      const hc2c_desc *e = ego->desc;
      UNUSED(v);
 
+     /* first pair of the range */
+     cr += mb * ms; ci += mb * ms;
+
      return (
 	  1
 	  && r == e->radix
@@ -220,21 +232,23 @@ static int applicable0(const S *ego, rdft_kind kind,
 
 	  /* first v-loop iteration */
 	  && ((*extra_iter = 0,
-	       e->genus->okp(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-			     rs, 1, (m+1)/2, ms, plnr))
+	       e->genus->okp(cr, ci, cr + (m-2*mb)*ms, ci + (m-2*mb)*ms,
+			     rs, mb, me, ms, plnr))
 	      ||
 	      (*extra_iter = 1,
-	       ((e->genus->okp(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-			       rs, 1, (m-1)/2, ms, plnr))
+	       me > mb
+	       &&
+	       ((e->genus->okp(cr, ci, cr + (m-2*mb)*ms, ci + (m-2*mb)*ms,
+			       rs, mb, me - 1, ms, plnr))
 		&&
-		(e->genus->okp(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-			       rs, (m-1)/2, (m-1)/2 + 2, 0, plnr)))))
+		(e->genus->okp(cr, ci, cr + (m-2*mb)*ms, ci + (m-2*mb)*ms,
+			       rs, me - 1, me + 1, 0, plnr)))))
 	  
 	  /* subsequent v-loop iterations */
 	  && (cr += vs, ci += vs, 1)
 
-	  && e->genus->okp(cr + ms, ci + ms, cr + (m-1)*ms, ci + (m-1)*ms,
-			   rs, 1, (m+1)/2 - *extra_iter, ms, plnr)
+	  && e->genus->okp(cr, ci, cr + (m-2*mb)*ms, ci + (m-2*mb)*ms,
+			   rs, mb, me - *extra_iter, ms, plnr)
 	  );
 }
 
@@ -242,12 +256,13 @@ static int applicable0_buf(const S *ego, rdft_kind kind,
 			   INT r, INT rs,
 			   INT m, INT ms, 
 			   INT v, INT vs,
+			   INT mb, INT me,
 			   const R *cr, const R *ci,
 			   const planner *plnr, INT *extra_iter)
 {
      const hc2c_desc *e = ego->desc;
      INT batchsz, brs;
-     UNUSED(v); UNUSED(rs); UNUSED(ms); UNUSED(vs);
+     UNUSED(v); UNUSED(rs); UNUSED(m); UNUSED(ms); UNUSED(vs);
 
      return (
 	  1
@@ -260,15 +275,15 @@ static int applicable0_buf(const S *ego, rdft_kind kind,
 	      brs = 4 * batchsz, 1)
 
 	  && e->genus->okp(cr, ci, cr + brs - 2, ci + brs - 2, 
-			   brs, 1, 1+batchsz, 2, plnr)
+			   brs, mb, mb+batchsz, 2, plnr)
 
 	  && ((*extra_iter = 0,
 	       e->genus->okp(cr, ci, cr + brs - 2, ci + brs - 2, 
-			     brs, 1, 1 + (((m-1)/2) % batchsz), 2, plnr))
+			     brs, mb, mb + ((me-mb) % batchsz), 2, plnr))
 	      ||
 	      (*extra_iter = 1,
 	       e->genus->okp(cr, ci, cr + brs - 2, ci + brs - 2, 
-			     brs, 1, 1 + 1 + (((m-1)/2) % batchsz), 2, plnr)))
+			     brs, mb, mb + 1 + ((me-mb) % batchsz), 2, plnr)))
 	      
 	  );
 }
@@ -277,16 +292,17 @@ static int applicable(const S *ego, rdft_kind kind,
 		      INT r, INT rs,
 		      INT m, INT ms, 
 		      INT v, INT vs,
+		      INT mb, INT me,
 		      R *cr, R *ci,
 		      const planner *plnr, INT *extra_iter)
 {
      if (ego->bufferedp) {
-	  if (!applicable0_buf(ego, kind, r, rs, m, ms, v, vs, cr, ci, plnr,
-			       extra_iter))
+	  if (!applicable0_buf(ego, kind, r, rs, m, ms, v, vs, mb, me, 
+			       cr, ci, plnr, extra_iter))
 	       return 0;
      } else {
-	  if (!applicable0(ego, kind, r, rs, m, ms, v, vs, cr, ci, plnr,
-			   extra_iter))
+	  if (!applicable0(ego, kind, r, rs, m, ms, v, vs, mb, me, 
+			   cr, ci, plnr, extra_iter))
 	       return 0;
      }
 
@@ -301,6 +317,7 @@ static plan *mkcldw(const hc2c_solver *ego_, rdft_kind kind,
 		    INT r, INT rs,
 		    INT m, INT ms, 
 		    INT v, INT vs,
+		    INT mb, INT me,
 		    R *cr, R *ci,
 		    planner *plnr)
 {
@@ -309,34 +326,44 @@ static plan *mkcldw(const hc2c_solver *ego_, rdft_kind kind,
      const hc2c_desc *e = ego->desc;
      plan *cld0 = 0, *cldm = 0;
      INT imid = (m / 2) * ms;
+     INT mcount = (m + 2) / 2;
+     INT kb = X(imax)(mb, 1), ke = X(imin)(me, (m + 1) / 2);
      INT extra_iter;
 
      static const plan_adt padt = {
 	  0, awake, print, destroy
      };
 
-     if (!applicable(ego, kind, r, rs, m, ms, v, vs, cr, ci, plnr, 
+     /* codelet butterflies 1..(m+1)/2-1 that fall in MB..ME-1 */
+     ke = X(imax)(ke, kb);
+
+     if (!applicable(ego, kind, r, rs, m, ms, v, vs, kb, ke, cr, ci, plnr, 
 		     &extra_iter))
           return (plan *)0;
 
-     cld0 = X(mkplan_d)(
-	  plnr, 
-	  X(mkproblem_rdft2_d)(X(mktensor_1d)(r, rs, rs),
-			       X(mktensor_0d)(),
-			       TAINT(cr, vs), TAINT(ci, vs),
-			       TAINT(cr, vs), TAINT(ci, vs),
-			       kind));
-     if (!cld0) goto nada;
-
-     cldm = X(mkplan_d)(
-	  plnr, 
-	  X(mkproblem_rdft2_d)(((m % 2) ?
-				X(mktensor_0d)() : X(mktensor_1d)(r, rs, rs) ),
-			       X(mktensor_0d)(),
-			       TAINT(cr + imid, vs), TAINT(ci + imid, vs),
-			       TAINT(cr + imid, vs), TAINT(ci + imid, vs),
-			       kind == R2HC ? R2HCII : HC2RIII));
-     if (!cldm) goto nada;
+     if (mb == 0) {
+	  cld0 = X(mkplan_d)(
+	       plnr, 
+	       X(mkproblem_rdft2_d)(X(mktensor_1d)(r, rs, rs),
+				    X(mktensor_0d)(),
+				    TAINT(cr, vs), TAINT(ci, vs),
+				    TAINT(cr, vs), TAINT(ci, vs),
+				    kind));
+	  if (!cld0) goto nada;
+     }
+
+     if (me == mcount) {
+	  cldm = X(mkplan_d)(
+	       plnr, 
+	       X(mkproblem_rdft2_d)(((m % 2) ?
+				     X(mktensor_0d)() : 
+				     X(mktensor_1d)(r, rs, rs) ),
+				    X(mktensor_0d)(),
+				    TAINT(cr + imid, vs), TAINT(ci + imid, vs),
+				    TAINT(cr + imid, vs), TAINT(ci + imid, vs),
+				    kind == R2HC ? R2HCII : HC2RIII));
+	  if (!cldm) goto nada;
+     }
 
      if (ego->bufferedp)
 	  pln = MKPLAN_HC2C(P, &padt, apply_buf);
@@ -347,6 +374,7 @@ static plan *mkcldw(const hc2c_solver *ego_, rdft_kind kind,
      pln->td = 0;
      pln->r = r; pln->rs = X(mkstride)(r, rs);
      pln->m = m; pln->ms = ms;
+     pln->mb = kb; pln->me = ke;
      pln->v = v; pln->vs = vs;
      pln->slv = ego;
      pln->brs = X(mkstride)(r, 4 * compute_batchsize(r));
@@ -355,13 +383,15 @@ static plan *mkcldw(const hc2c_solver *ego_, rdft_kind kind,
      pln->extra_iter = extra_iter;
 
      X(ops_zero)(&pln->super.super.ops);
-     X(ops_madd2)(v * (((m - 1) / 2) / e->genus->vl),
+     X(ops_madd2)(v * ((ke - kb) / e->genus->vl),
 		  &e->ops, &pln->super.super.ops);
-     X(ops_madd2)(v, &cld0->ops, &pln->super.super.ops);
-     X(ops_madd2)(v, &cldm->ops, &pln->super.super.ops);
+     if (cld0)
+	  X(ops_madd2)(v, &cld0->ops, &pln->super.super.ops);
+     if (cldm)
+	  X(ops_madd2)(v, &cldm->ops, &pln->super.super.ops);
 
      if (ego->bufferedp) 
-	  pln->super.super.ops.other += 4 * r * m * v;
+	  pln->super.super.ops.other += 4 * r * v * (m * (me - mb)) / mcount;
 
      return &(pln->super.super);
 
@@ -381,6 +411,14 @@ static void regone(planner *plnr, khc2c codelet,
      slv->desc = desc;
      slv->bufferedp = bufferedp;
      REGISTER_SOLVER(plnr, &(slv->super.super));
+     if (X(mksolver_hc2c_hook)) {
+	  slv = (S *)X(mksolver_hc2c_hook)(sizeof(S), desc->radix, 
+					   hc2ckind, mkcldw);
+	  slv->k = codelet;
+	  slv->desc = desc;
+	  slv->bufferedp = bufferedp;
+	  REGISTER_SOLVER(plnr, &(slv->super.super));
+     }
 }
 
 void X(regsolver_hc2c_direct)(planner *plnr, khc2c codelet,
@@ -21,6 +21,9 @@
 #include "ct-hc2c.h"
 #include "dft.h"
 
+hc2c_solver *(*X(mksolver_hc2c_hook))(size_t, INT, hc2c_kind,
+				      hc2c_mkinferior) = 0;
+
 typedef struct {
      plan_rdft2 super;
      plan *cld;
@@ -174,6 +177,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
 				 r, m * d[0].os, 
 				 m, d[0].os,
 				 v, ovs,
+				 0, (m+2)/2,
 				 p->cr, p->ci, plnr);
 	      if (!cldw) goto nada;
 
@@ -216,6 +220,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
 				 r, m * d[0].is, 
 				 m, d[0].is,
 				 v, ivs,
+				 0, (m+2)/2,
 				 p->cr, p->ci, plnr);
 	      if (!cldw) goto nada;
 
@@ -22,10 +22,15 @@
 
 typedef void (*hc2capply) (const plan *ego, R *cr, R *ci);
 typedef struct hc2c_solver_s hc2c_solver;
+
+/* The inferior plan computes the butterflies j = MB..ME-1 of the
+   m + 1 - m/2 = (m+2)/2 that make up the twiddle pass: butterfly 0,
+   the pairs (j, m-j), and butterfly m/2 for even m. */
 typedef plan *(*hc2c_mkinferior)(const hc2c_solver *ego, rdft_kind kind,
 				 INT r, INT rs,
 				 INT m, INT ms, 
 				 INT v, INT vs,
+				 INT mb, INT me,
 				 R *cr, R *ci,
 				 planner *plnr);
 
@@ -51,6 +56,10 @@ struct hc2c_solver_s {
 hc2c_solver *X(mksolver_hc2c)(size_t size, INT r,
 			      hc2c_kind hc2ckind,
 			      hc2c_mkinferior mkcldw);
+extern hc2c_solver *(*X(mksolver_hc2c_hook))(size_t, INT, hc2c_kind,
+					     hc2c_mkinferior);
+
+int X(hc2c_applicable)(const hc2c_solver *, const problem *, planner *);
 
 void X(regsolver_hc2c_direct)(planner *plnr, khc2c codelet, 
 			      const hc2c_desc *desc,
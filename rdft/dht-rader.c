@@ -154,23 +154,23 @@ static void apply(const plan *ego_, R *I, R *O)
      X(ifree)(buf);
 }
 
-static R *mkomega(enum wakefulness wakefulness,
-		  plan *p_, INT n, INT npad, INT ginv)
+typedef struct {
+     enum wakefulness wakefulness;
+     plan *p;
+     INT n, npad, ginv;
+} omega_closure;
+
+static void fill_omega(R *omega, void *data)
 {
-     plan_rdft *p = (plan_rdft *) p_;
-     R *omega;
-     INT i, gpower;
+     const omega_closure *c = (const omega_closure *) data;
+     plan_rdft *p = (plan_rdft *) c->p;
+     INT i, gpower, n = c->n, npad = c->npad, ginv = c->ginv;
      trigreal scale;
      triggen *t;
 
-     if ((omega = X(rader_tl_find)(n, npad + 1, ginv, omegas))) 
-	  return omega;
-
-     omega = (R *)MALLOC(sizeof(R) * npad, TWIDDLES);
-
      scale = npad; /* normalization for convolution */
 
-     t = X(mktriggen)(wakefulness, n);
+     t = X(mktriggen)(c->wakefulness, n);
      for (i = 0, gpower = 1; i < n-1; ++i, gpower = MULMOD(gpower, ginv, n)) {
 	  trigreal w[2];
 	  t->cexpl(t, gpower, w);
@@ -187,7 +187,32 @@ static R *mkomega(enum wakefulness wakefulness,
 	  for (i = 1; i < n-1; ++i)
 	       omega[npad - i] = omega[n - 1 - i];
 
-     p->apply(p_, omega, omega);
+     p->apply(c->p, omega, omega);
+}
+
+static R *mkomega(enum wakefulness wakefulness,
+		  plan *p_, INT n, INT npad, INT ginv)
+{
+     R *omega;
+     omega_closure c;
+     md5 key;
+
+     if ((omega = X(rader_tl_find)(n, npad + 1, ginv, omegas))) 
+	  return omega;
+
+     c.wakefulness = wakefulness;
+     c.p = p_;
+     c.n = n;
+     c.npad = npad;
+     c.ginv = ginv;
+
+     X(md5begin)(&key);
+     X(md5puts)(&key, "dht-rader");
+     X(md5int)(&key, (int) wakefulness);
+     X(md5INT)(&key, n);
+     X(md5INT)(&key, npad);
+     X(md5INT)(&key, ginv);
+     omega = X(shmtab_mk)(&key, npad, fill_omega, &c);
 
      X(rader_tl_insert)(n, npad + 1, ginv, omega, &omegas);
      return omega;
@@ -51,6 +51,18 @@ static void hash(const problem *p_, md5 *m)
      X(tensor_md5)(m, p->vecsz);
 }
 
+static void hash_layout(const problem *p_, md5 *m)
+{
+     const problem_rdft *p = (const problem_rdft *) p_;
+     X(md5puts)(m, "rdft-layout");
+     X(md5int)(m, p->I == p->O);
+     kind_hash(m, p->kind, p->sz->rnk);
+     X(md5int)(m, X(alignment_of)(p->I));
+     X(md5int)(m, X(alignment_of)(p->O));
+     X(tensor_md5_layout)(m, p->sz);
+     X(tensor_md5_layout)(m, p->vecsz);
+}
+
 static void recur(const iodim *dims, int rnk, R *I)
 {
      if (rnk == RNK_MINFTY)
@@ -117,6 +129,7 @@ static const problem_adt padt =
 {
      PROBLEM_RDFT,
      hash,
+     hash_layout,
      zero,
      print,
      destroy
@@ -46,6 +46,22 @@ static void hash(const problem *p_, md5 *m)
      X(tensor_md5)(m, p->vecsz);
 }
 
+static void hash_layout(const problem *p_, md5 *m)
+{
+     const problem_rdft2 *p = (const problem_rdft2 *) p_;
+     X(md5puts)(m, "rdft2-layout");
+     X(md5int)(m, p->r0 == p->cr);
+     X(md5INT)(m, p->r1 - p->r0);
+     X(md5INT)(m, p->ci - p->cr);
+     X(md5int)(m, X(alignment_of)(p->r0));
+     X(md5int)(m, X(alignment_of)(p->r1));
+     X(md5int)(m, X(alignment_of)(p->cr)); 
+     X(md5int)(m, X(alignment_of)(p->ci)); 
+     X(md5int)(m, p->kind);
+     X(tensor_md5_layout)(m, p->sz);
+     X(tensor_md5_layout)(m, p->vecsz);
+}
+
 static void print(const problem *ego_, printer *p)
 {
      const problem_rdft2 *ego = (const problem_rdft2 *) ego_;
@@ -137,6 +153,7 @@ static const problem_adt padt =
 {
      PROBLEM_RDFT2,
      hash,
+     hash_layout,
      zero,
      print,
      destroy
@@ -41,6 +41,7 @@ typedef struct {
      solver super;
      rdftapply apply;
      int (*applicable)(const P *pln, const problem_rdft *p);
+     int (*fill)(P *pln, const problem_rdft *p);
      const char *nam;
 } S;
 
@@ -67,6 +68,50 @@ static int fill_iodim(P *pln, const problem_rdft *p)
      return 1;
 }
 
+/* copy up to MAXRNK dimensions from problem into plan, sorted by
+   decreasing output stride, fusing the dimensions that form a single
+   loop in both the input and the output.  If the last dimension is
+   contiguous, save its length in pln->vl */
+static int fill_nd(P *pln, const problem_rdft *p)
+{
+     const tensor *vecsz = p->vecsz;
+     iodim *d = pln->d;
+     int i, j, rnk = vecsz->rnk;
+
+     if (rnk > MAXRNK)
+	  return 0;
+
+     /* insertion sort by decreasing |os|, then decreasing |is| */
+     for (i = 0; i < rnk; ++i) {
+	  iodim t = vecsz->dims[i];
+	  INT aos = X(iabs)(t.os), ais = X(iabs)(t.is);
+	  for (j = i; j > 0; --j) {
+	       INT bos = X(iabs)(d[j - 1].os), bis = X(iabs)(d[j - 1].is);
+	       if (bos > aos || (bos == aos && bis >= ais))
+		    break;
+	       d[j] = d[j - 1];
+	  }
+	  d[j] = t;
+     }
+
+     for (i = j = 0; i < rnk; ++i) {
+	  if (j > 0
+	      && d[j - 1].is == d[i].is * d[i].n
+	      && d[j - 1].os == d[i].os * d[i].n) {
+	       d[j - 1].n *= d[i].n;
+	       d[j - 1].is = d[i].is;
+	       d[j - 1].os = d[i].os;
+	  } else
+	       d[j++] = d[i];
+     }
+
+     pln->vl = 1;
+     if (j > 0 && d[j - 1].is == 1 && d[j - 1].os == 1)
+	  pln->vl = d[--j].n;
+     pln->rnk = j;
+     return 1;
+}
+
 /* generic higher-rank copy routine, calls cpy2d() to do the real work */
 static void copy(const iodim *d, int rnk, INT vl,
 		 R *I, R *O,
@@ -288,6 +333,45 @@ static void apply_ip_sq_tiledbuf(const plan *ego_, R *I, R *O)
 
 #define applicable_ip_sq_tiledbuf applicable_ip_sq_tiled
 
+/**************************************************************/
+/* out of place, any rank and permutation, recursively blocked (the
+   dimensions are reordered by fill_nd) */
+static void apply_nd(const plan *ego_, R *I, R *O)
+{
+     const P *ego = (const P *) ego_;
+     X(cpynd)(I, O, ego->rnk, ego->d, ego->vl, 0);
+}
+
+static int applicable_nd(const P *pln, const problem_rdft *p)
+{
+     return (1
+	     && p->I != p->O
+	     && pln->rnk >= 2
+	  );
+}
+
+/**************************************************************/
+/* as above, with non-temporal stores */
+
+/* roughly a last-level cache, in bytes: smaller outputs are likely
+   to be read again from the cache */
+#define NT_MINSZ ((INT) 8 << 20)
+
+static void apply_nd_nt(const plan *ego_, R *I, R *O)
+{
+     const P *ego = (const P *) ego_;
+     X(cpynd)(I, O, ego->rnk, ego->d, ego->vl, 1);
+}
+
+static int applicable_nd_nt(const P *pln, const problem_rdft *p)
+{
+     return (1
+	     && applicable_nd(pln, p)
+	     && X(cpynd_widep)(pln->vl)
+	     && X(tensor_sz)(p->vecsz) * (INT) sizeof(R) >= NT_MINSZ
+	  );
+}
+
 /**************************************************************/
 static int applicable(const S *ego, const problem *p_)
 {
@@ -296,7 +380,7 @@ static int applicable(const S *ego, const problem *p_)
      return (1
 	     && p->sz->rnk == 0
 	     && FINITE_RNK(p->vecsz->rnk)
-	     && fill_iodim(&pln, p)
+	     && ego->fill(&pln, p)
 	     && ego->applicable(&pln, p)
 	  );
 }
@@ -330,7 +414,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      p = (const problem_rdft *) p_;
      pln = MKPLAN_RDFT(P, &padt, ego->apply);
 
-     retval = fill_iodim(pln, p);
+     retval = ego->fill(pln, p);
      (void)retval; /* UNUSED unless DEBUG */
      A(retval);
      A(pln->vl > 0); /* because FINITE_RNK(p->vecsz->rnk) holds */
@@ -349,6 +433,7 @@ void X(rdft_rank0_register)(planner *p)
 	  rdftapply apply;
 	  int (*applicable)(const P *, const problem_rdft *);
 	  const char *nam;
+	  int (*fill)(P *, const problem_rdft *); /* default fill_iodim */
      } tab[] = {
 	  { apply_memcpy,   applicable_memcpy,   "rdft-rank0-memcpy" },
 	  { apply_memcpy_loop,   applicable_memcpy_loop,  
@@ -368,6 +453,8 @@ void X(rdft_rank0_register)(planner *p)
 	       applicable_ip_sq_tiledbuf,
 	       "rdft-rank0-ip-sq-tiledbuf" 
 	  },
+	  { apply_nd,       applicable_nd,       "rdft-rank0-nd",   fill_nd },
+	  { apply_nd_nt,    applicable_nd_nt,    "rdft-rank0-nd-nt", fill_nd },
      };
 
      for (i = 0; i < sizeof(tab) / sizeof(tab[0]); ++i) {
@@ -375,6 +462,7 @@ void X(rdft_rank0_register)(planner *p)
 	  S *slv = MKSOLVER(S, &sadt);
 	  slv->apply = tab[i].apply;
 	  slv->applicable = tab[i].applicable;
+	  slv->fill = tab[i].fill ? tab[i].fill : fill_iodim;
 	  slv->nam = tab[i].nam;
 	  REGISTER_SOLVER(p, &(slv->super));
      }
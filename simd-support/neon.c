@@ -23,8 +23,15 @@
 
 #if HAVE_NEON
 
+#if defined(__aarch64__)
+/* Advanced SIMD is part of the base AArch64 architecture */
+  int X(have_simd_neon)(void)
+  {
+       return 1;
+  }
+
 /* check for an environment where signals are known to work */
-#if defined(unix) || defined(linux)
+#elif defined(unix) || defined(linux)
   # include <signal.h>
   # include <setjmp.h>
 
@@ -18,23 +18,36 @@
  *
  */
 
-#ifndef FFTW_SINGLE
-#error "NEON only works in single precision"
+#if defined(FFTW_LDOUBLE) || defined(FFTW_QUAD)
+#error "NEON only works in single or double precision"
+#endif
+
+#ifdef FFTW_SINGLE
+#  define DS(d,s) s /* single-precision option */
+#else
+#  define DS(d,s) d /* double-precision option */
 #endif
 
 /* define these unconditionally, because they are used by
    taint.c which is compiled without neon */
 #define SIMD_SUFFIX _neon	/* for renaming */
-#define VL 2            /* SIMD complex vector length */
-#define SIMD_VSTRIDE_OKA(x) ((x) == 2)
+#define VL DS(1,2)         /* SIMD complex vector length */
+#define SIMD_VSTRIDE_OKA(x) DS(1,((x) == 2))
 #define SIMD_STRIDE_OKPAIR SIMD_STRIDE_OK
 
-#if defined(__GNUC__) && !defined(__ARM_NEON__)
+#if defined(__GNUC__) && !defined(__ARM_NEON__) && !defined(__ARM_NEON)
 #error "compiling simd-neon.h requires -mfpu=neon or equivalent"
 #endif
 
+/* float64x2_t is AArch64 Advanced SIMD only */
+#if !defined(FFTW_SINGLE) && !defined(__aarch64__)
+#error "double-precision NEON requires AArch64; 32-bit ARM NEON supports single precision only"
+#endif
+
 #include <arm_neon.h>
 
+#ifdef FFTW_SINGLE
+
 /* FIXME: I am not sure whether this code assumes little-endian
    ordering.  VLIT may or may not be wrong for big-endian systems. */
 typedef float32x4_t V;
@@ -261,6 +274,200 @@ static inline V BYTWJ2(const R *t, V sr)
     {TW_SIN, v, x}, {TW_SIN, v+1, x}, {TW_SIN, v+2, x}, {TW_SIN, v+3, x}
 #define TWVLS (2 * VL)
 
+#else /* double precision, AArch64 only */
+
+/* One complex number per vector, real part in lane 0.  VFMA and
+   VFNMS map onto the fused FMLA and FMLS of AArch64. */
+typedef float64x2_t V;
+
+#define VLIT(x0, x1) {x0, x1}
+#define LDK(x) x
+#define DVK(var, val) const V var = VLIT(val, val)
+
+#define VADD(a, b) vaddq_f64(a, b)
+#define VSUB(a, b) vsubq_f64(a, b)
+#define VMUL(a, b) vmulq_f64(a, b)
+#define VNEG(a) vnegq_f64(a)
+#define VFMA(a, b, c) vfmaq_f64(c, a, b)		/* a*b+c */
+#define VFNMS(a, b, c) vfmsq_f64(c, a, b)	/* c-a*b */
+#define VFMS(a, b, c) VNEG(VFNMS(a, b, c))	/* a*b-c */
+
+static inline V LDA(const R *x, INT ivs, const R *aligned_like)
+{
+     (void) ivs;		/* UNUSED */
+     (void) aligned_like;	/* UNUSED */
+     return vld1q_f64((const float64_t *)x);
+}
+
+static inline void STA(R *x, V v, INT ovs, const R *aligned_like)
+{
+     (void) ovs;		/* UNUSED */
+     (void) aligned_like;	/* UNUSED */
+     vst1q_f64((float64_t *)x, v);
+}
+
+#define LD LDA
+#define ST STA
+
+/* 2x2 complex transpose and store */
+#define STM2 STA
+#define STN2(x, v0, v1, ovs) /* nop */
+
+/* store and 4x4 real transpose */
+static inline void STM4(R *x, V v, INT ovs, const R *aligned_like)
+{
+     (void) aligned_like;	/* UNUSED */
+     vst1q_lane_f64((float64_t *)x, v, 0);
+     vst1q_lane_f64((float64_t *)(x + ovs), v, 1);
+}
+#define STN4(x, v0, v1, v2, v3, ovs)	/* use STM4 */
+
+#define FLIP_RI(x) vextq_f64(x, x, 1)
+
+static inline V VCONJ(V x)
+{
+     static const uint64x2_t pm = {0, 0x8000000000000000ull};
+     return vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(x), pm));
+}
+
+static inline V VBYI(V x)
+{
+     return FLIP_RI(VCONJ(x));
+}
+
+/* ARMv8.3 complex arithmetic: FCADD adds B rotated by 90 or 270
+   degrees, and a pair of FCMLA computes a full complex product */
+#if defined(__ARM_FEATURE_COMPLEX)
+#define VFMAI(b, c) vcaddq_rot90_f64(c, b)	/* c+i*b */
+#define VFNMSI(b, c) vcaddq_rot270_f64(c, b)	/* c-i*b */
+#else
+static inline V VFMAI(V b, V c)
+{
+     return VADD(c, VBYI(b));
+}
+
+static inline V VFNMSI(V b, V c)
+{
+     return VSUB(c, VBYI(b));
+}
+#endif
+
+static inline V VFMACONJ(V b, V c)
+{
+     return VADD(VCONJ(b), c);
+}
+
+static inline V VFMSCONJ(V b, V c)
+{
+     return VSUB(VCONJ(b), c);
+}
+
+static inline V VFNMSCONJ(V b, V c)
+{
+     return VSUB(c, VCONJ(b));
+}
+
+#define VEXTRACT_REIM(tr, ti, tx)		\
+{						\
+     tr = vdupq_laneq_f64(tx, 0);		\
+     ti = vdupq_laneq_f64(tx, 1);		\
+}
+
+#if defined(__ARM_FEATURE_COMPLEX)
+static inline V VZMUL(V tx, V sr)
+{
+     const V zero = vdupq_n_f64(0.0);
+     return vcmlaq_rot90_f64(vcmlaq_f64(zero, tx, sr), tx, sr);
+}
+
+static inline V VZMULJ(V tx, V sr)
+{
+     const V zero = vdupq_n_f64(0.0);
+     return vcmlaq_rot270_f64(vcmlaq_f64(zero, tx, sr), tx, sr);
+}
+#else
+static inline V VZMUL(V tx, V sr)
+{
+     V tr, ti;
+     VEXTRACT_REIM(tr, ti, tx);
+     tr = VMUL(sr, tr);
+     sr = VBYI(sr);
+     return VFMA(ti, sr, tr);
+}
+
+static inline V VZMULJ(V tx, V sr)
+{
+     V tr, ti;
+     VEXTRACT_REIM(tr, ti, tx);
+     tr = VMUL(sr, tr);
+     sr = VBYI(sr);
+     return VFNMS(ti, sr, tr);
+}
+#endif
+
+static inline V VZMULI(V tx, V sr)
+{
+     V tr, ti;
+     VEXTRACT_REIM(tr, ti, tx);
+     ti = VMUL(ti, sr);
+     sr = VBYI(sr);
+     return VFMS(tr, sr, ti);
+}
+
+static inline V VZMULIJ(V tx, V sr)
+{
+     V tr, ti;
+     VEXTRACT_REIM(tr, ti, tx);
+     ti = VMUL(ti, sr);
+     sr = VBYI(sr);
+     return VFMA(tr, sr, ti);
+}
+
+/* twiddle storage #1: compact, slower */
+#define VTW1(v,x) {TW_CEXP, v, x}
+#define TWVL1 VL
+static inline V BYTW1(const R *t, V sr)
+{
+     V tx = LDA(t, 2, 0);
+     return VZMUL(tx, sr);
+}
+
+static inline V BYTWJ1(const R *t, V sr)
+{
+     V tx = LDA(t, 2, 0);
+     return VZMULJ(tx, sr);
+}
+
+/* twiddle storage #2: twice the space, faster (when in cache) */
+#define VTW2(v,x)							\
+  {TW_COS, v, x}, {TW_COS, v, x}, {TW_SIN, v, -x}, {TW_SIN, v, x}
+#define TWVL2 (2 * VL)
+
+static inline V BYTW2(const R *t, V sr)
+{
+     V si = FLIP_RI(sr);
+     V tr = LDA(t, 2, 0), ti = LDA(t+2*VL, 2, 0);
+     return VFMA(ti, si, VMUL(tr, sr));
+}
+
+static inline V BYTWJ2(const R *t, V sr)
+{
+     V si = FLIP_RI(sr);
+     V tr = LDA(t, 2, 0), ti = LDA(t+2*VL, 2, 0);
+     return VFNMS(ti, si, VMUL(tr, sr));
+}
+
+/* twiddle storage #3 */
+#define VTW3(v,x) {TW_CEXP, v, x}
+#define TWVL3 (VL)
+
+/* twiddle storage for split arrays */
+#define VTWS(v,x)							\
+  {TW_COS, v, x}, {TW_COS, v+1, x}, {TW_SIN, v, x}, {TW_SIN, v+1, x}
+#define TWVLS (2 * VL)
+
+#endif /* FFTW_SINGLE */
+
 #define VLEAVE()		/* nothing */
 
 #include "simd-common.h"
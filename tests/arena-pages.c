@@ -0,0 +1,47 @@
+/* Check that destroying one plan arena leaves the data of another
+   arena intact.  Arenas are neighbours in memory, and the pages of an
+   arena are returned to the system when it goes away, so they must
+   not overlap the arena next to it.  The first block of the first
+   arena is larger than a chunk and not a whole number of pages. */
+
+#include <stdio.h>
+#include <string.h>
+#define CALLING_FFTW /* hack for Windows DLL nonsense */
+#include "api.h"
+
+#define BIG 100000
+#define SMALL 1000
+
+int main(void)
+{
+     arena *a, *b;
+     char *big, *small;
+     int i, fail = 0;
+
+     if (!X(arena_set_flags)(ARENA_ON)) {
+	  printf("plan arenas not supported\n");
+	  return 77; /* skipped */
+     }
+
+     a = X(arena_begin)();
+     big = (char *) X(arena_malloc)(BIG);
+     X(arena_end)(a);
+
+     b = X(arena_begin)();
+     small = (char *) X(arena_malloc)(SMALL);
+     X(arena_end)(b);
+     memset(small, 0x5a, SMALL);
+
+     X(ifree)(big); /* destroys A */
+
+     for (i = 0; i < SMALL; ++i)
+	  if (small[i] != 0x5a) {
+	       printf("arena data lost at byte %d\n", i);
+	       ++fail;
+	       break;
+	  }
+
+     X(ifree)(small);
+     X(arena_set_flags)(0);
+     return fail != 0;
+}
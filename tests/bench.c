@@ -527,6 +527,63 @@ FFTW(plan) mkplan(bench_problem *p, unsigned flags)
      }
 }
 
+/* execute PLN on the arrays of P, which must have the same layout
+   as those PLN was created for */
+void execute_on(FFTW(plan) pln, bench_problem *p)
+{
+     bench_real *ri, *ii, *ro, *io;
+
+     switch (p->kind) {
+	 case PROBLEM_COMPLEX:
+	      if (p->split) {
+		   extract_reim_split(p->sign, p->iphyssz,
+				      (bench_real *) p->in, &ri, &ii);
+		   extract_reim_split(p->sign, p->ophyssz,
+				      (bench_real *) p->out, &ro, &io);
+		   FFTW(execute_split_dft)(pln, ri, ii, ro, io);
+	      } else
+		   FFTW(execute_dft)(pln, (FFTW(complex) *) p->in,
+				     (FFTW(complex) *) p->out);
+	      break;
+	 case PROBLEM_REAL:
+	      if (p->split) {
+		   int n2 = halfish_sizeof_problem(p);
+		   extract_reim_split(FFTW_FORWARD, n2,
+				      (bench_real *) p->in, &ri, &ii);
+		   extract_reim_split(FFTW_FORWARD, n2,
+				      (bench_real *) p->out, &ro, &io);
+		   if (p->sign < 0)
+			FFTW(execute_split_dft_r2c)(pln, ri, ro, io);
+		   else
+			FFTW(execute_split_dft_c2r)(pln, ri, ii, ro);
+	      } else if (p->sign < 0)
+		   FFTW(execute_dft_r2c)(pln, (bench_real *) p->in,
+					 (FFTW(complex) *) p->out);
+	      else
+		   FFTW(execute_dft_c2r)(pln, (FFTW(complex) *) p->in,
+					 (bench_real *) p->out);
+	      break;
+	 case PROBLEM_R2R:
+	      FFTW(execute_r2r)(pln, (bench_real *) p->in,
+				(bench_real *) p->out);
+	      break;
+	 default:
+	      BENCH_ASSERT(0);
+     }
+}
+
+/* split-phase execution is only for MPI plans, see mpi-bench.c */
+void execute_plan(FFTW(plan) pln)
+{
+     FFTW(execute)(pln);
+}
+
+/* the plans execute on the arrays of the problem itself */
+void plan_done(bench_problem *p)
+{
+     UNUSED(p);
+}
+
 void main_init(int *argc, char ***argv)
 {
      UNUSED(argc);
@@ -22,6 +22,7 @@ $flushcount = 42;
 $mpi = 0;
 $mpi_transposed_in = 0;
 $mpi_transposed_out = 0;
+$mpi_split_phase = 0;
 
 sub make_options {
     my $options = $default_options;
@@ -35,6 +36,7 @@ sub make_options {
     $options = "-o nthreads=$nthreads $options" if ($nthreads > 1);
     $options = "-obflag=30 $options" if $mpi_transposed_in;
     $options = "-obflag=31 $options" if $mpi_transposed_out;
+    $options = "-o split-phase $options" if $mpi_split_phase;
     return $options;
 }
 
@@ -278,6 +280,8 @@ sub parse_arguments (@)
 	    ++$mpi; ++$mpi_transposed_in; }
 	elsif ($arglist[0] eq '--mpi-transposed-out') {
 	    ++$mpi; ++$mpi_transposed_out; }
+	elsif ($arglist[0] eq '--mpi-split-phase') {
+	    ++$mpi; ++$mpi_split_phase; }
 	
 	elsif ($arglist[0] eq '-0d') { ++$do_0d; }
 	elsif ($arglist[0] eq '-1d') { ++$do_1d; }
@@ -0,0 +1,76 @@
+/* Check the accuracy of double-double transforms, only built with
+   --enable-double-double.  The high parts of the forward transform
+   must agree with a DFT computed in ordinary floating point to about
+   double precision, and a forward and backward transform must return
+   the input to about 1e-30, far beyond what double precision can
+   achieve. */
+
+#include <stdio.h>
+#include <math.h>
+#include "fftw-bench.h"
+
+#define N 360
+
+int main(void)
+{
+     FFTW(complex) *x, *y, *z;
+     FFTW(plan) fwd, bwd;
+     double err, amax;
+     int i, j, fail = 0;
+
+     x = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * N);
+     y = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * N);
+     z = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * N);
+     fwd = FFTW(plan_dft_1d)(N, x, y, FFTW_FORWARD, FFTW_ESTIMATE);
+     bwd = FFTW(plan_dft_1d)(N, y, z, FFTW_BACKWARD, FFTW_ESTIMATE);
+
+     /* inputs that need both halves of a double-double */
+     for (j = 0; j < N; ++j) {
+	  double a = sin(j * 0.7), b = cos(j * 1.3);
+	  x[j][0] = bench_real(a) + bench_real(b) * bench_real(1e-20);
+	  x[j][1] = bench_real(b) - bench_real(a) * bench_real(1e-20);
+     }
+     FFTW(execute)(fwd);
+
+     /* the forward transform, to double precision */
+     for (err = amax = 0.0, i = 0; i < N; ++i) {
+	  long double re = 0, im = 0;
+	  for (j = 0; j < N; ++j) {
+	       long double t = -2 * 3.141592653589793238462643383279503L
+		    * ((long) i * j % N) / N;
+	       long double xr = (long double) x[j][0].hi + x[j][0].lo;
+	       long double xi = (long double) x[j][1].hi + x[j][1].lo;
+	       re += xr * cosl(t) - xi * sinl(t);
+	       im += xr * sinl(t) + xi * cosl(t);
+	  }
+	  err = fmax(err, fabs((double) (re - y[i][0].hi)));
+	  err = fmax(err, fabs((double) (im - y[i][1].hi)));
+	  amax = fmax(amax, fabs((double) re) + fabs((double) im));
+     }
+     if (err > 1e-13 * amax) {
+	  printf("forward transform differs from the DFT: %g\n", err / amax);
+	  ++fail;
+     }
+
+     /* the round trip, to double-double precision */
+     FFTW(execute)(bwd);
+     for (err = amax = 0.0, j = 0; j < N; ++j) {
+	  bench_real dr = z[j][0] / bench_real(N) - x[j][0];
+	  bench_real di = z[j][1] / bench_real(N) - x[j][1];
+	  err = fmax(err, fabs((double) dr) + fabs((double) di));
+	  amax = fmax(amax, fabs((double) x[j][0]) + fabs((double) x[j][1]));
+     }
+     if (err > 1e-28 * amax) {
+	  printf("round trip error %g is not double-double accurate\n",
+		 err / amax);
+	  ++fail;
+     }
+
+     FFTW(destroy_plan)(bwd);
+     FFTW(destroy_plan)(fwd);
+     FFTW(free)(z);
+     FFTW(free)(y);
+     FFTW(free)(x);
+     FFTW(cleanup)();
+     return fail != 0;
+}
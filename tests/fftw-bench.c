@@ -1,6 +1,12 @@
 /* See bench.c.  We keep a few common subroutines in this file so
    that they can be re-used in the MPI test program. */
 
+#include "config.h" /* before any test of HAVE_* */
+
+#if defined(HAVE_SCHED_SETAFFINITY) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE /* for cpu_set_t */
+#endif
+
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
@@ -8,6 +14,12 @@
 
 #ifdef _OPENMP
 #  include <omp.h>
+#elif defined(HAVE_SMP) && defined(USING_POSIX_THREADS)
+#  include <pthread.h>
+#endif
+
+#ifdef HAVE_SCHED_SETAFFINITY
+#  include <sched.h>
 #endif
 
 #ifdef HAVE_SMP
@@ -22,11 +34,21 @@ int paranoid = 0;
 int usewisdom = 0;
 int havewisdom = 0;
 int nthreads = 1;
+int telemetry = 0;
+int threads_callback = 0;
+int planner_stats = 0;
+int memory_cap = 0;
 int amnesia = 0;
+int split_phase = 0;
 
 extern void install_hook(void);  /* in hook.c */
 extern void uninstall_hook(void);  /* in hook.c */
 
+#ifdef HAVE_SMP
+static void parallel_loop(void *(*work)(char *), char *jobdata,
+			  size_t elsize, int njobs, void *data);
+#endif
+
 #ifdef FFTW_RANDOM_ESTIMATOR
 extern unsigned FFTW(random_estimate_seed);
 #endif
@@ -44,18 +66,36 @@ void useropt(const char *arg)
      else if (!strcmp(arg, "nosimd")) the_flags |= FFTW_NO_SIMD;
      else if (!strcmp(arg, "noindirectop")) the_flags |= FFTW_NO_INDIRECT_OP;
      else if (!strcmp(arg, "wisdom-only")) the_flags |= FFTW_WISDOM_ONLY;
+     else if (!strcmp(arg, "wisdom-layout")) the_flags |= FFTW_WISDOM_LAYOUT;
      else if (sscanf(arg, "flag=%d", &x) == 1) the_flags |= x;
      else if (sscanf(arg, "bflag=%d", &x) == 1) the_flags |= 1U << x;
      else if (!strcmp(arg, "paranoid")) paranoid = 1;
      else if (!strcmp(arg, "wisdom")) usewisdom = 1;
      else if (!strcmp(arg, "amnesia")) amnesia = 1;
      else if (sscanf(arg, "nthreads=%d", &x) == 1) nthreads = x;
+     else if (!strcmp(arg, "telemetry")) telemetry = 1;
+     else if (!strcmp(arg, "threads-callback")) threads_callback = 1;
+     else if (!strcmp(arg, "planner-stats")) planner_stats = 1;
+     else if (!strcmp(arg, "split-phase")) split_phase = 1;
 #ifdef FFTW_RANDOM_ESTIMATOR
      else if (sscanf(arg, "eseed=%d", &x) == 1) FFTW(random_estimate_seed) = x;
 #endif
      else if (sscanf(arg, "timelimit=%lg", &y) == 1) {
 	  FFTW(set_timelimit)(y);
      }
+     else if (sscanf(arg, "memory-cap=%d", &x) == 1) {
+	  FFTW(set_plan_memory_cap)((size_t) x);
+	  memory_cap = 1;
+     }
+     else if (!strcmp(arg, "arena") || sscanf(arg, "arena=%d", &x) == 1) {
+	  if (!FFTW(plan_with_arena)(strcmp(arg, "arena") ? x : FFTW_ARENA_ON))
+	       fprintf(stderr, "bench: WARNING - plan arenas not supported\n");
+     }
+     else if (!strncmp(arg, "shared-tables=", 14)) {
+	  if (!FFTW(set_shared_tables)(arg + 14))
+	       fprintf(stderr, "bench: WARNING - cannot share tables in %s\n",
+		       arg + 14);
+     }
 
      else fprintf(stderr, "unknown user option: %s.  Ignoring.\n", arg);
 }
@@ -72,6 +112,9 @@ void rdwisdom(void)
      if (threads_ok) {
 	  BENCH_ASSERT(FFTW(init_threads)());
 	  FFTW(plan_with_nthreads)(nthreads);
+	  FFTW(plan_with_thread_telemetry)(telemetry);
+	  if (threads_callback)
+	       FFTW(threads_set_callback)(parallel_loop, 0);
 #ifdef _OPENMP
 	  omp_set_num_threads(nthreads);
 #endif
@@ -178,18 +221,25 @@ void setup(bench_problem *p)
      if (verbose > 1 && nthreads > 1) printf("NTHREADS = %d\n", nthreads);
 #endif
 
+     if (planner_stats)
+	  FFTW(reset_planner_stats)();
+
      timer_start(USER_TIMER);
      the_plan = mkplan(p, preserve_input_flags(p) | the_flags);
      tim = timer_stop(USER_TIMER);
      if (verbose > 1) printf("planner time: %g s\n", tim);
+     if (planner_stats)
+	  FFTW(fprint_planner_stats)(stdout);
 
      BENCH_ASSERT(the_plan);
+     p->userinfo = the_plan; /* several problems may be live, see replay */
      
      {
 	  double add, mul, nfma, cost, pcost;
 	  FFTW(flops)(the_plan, &add, &mul, &nfma);
 	  cost = FFTW(estimate_cost)(the_plan);
 	  pcost = FFTW(cost)(the_plan);
+	  p->flops = add + mul + 2 * nfma;
 	  if (verbose > 1) {
 	       FFTW(print_plan)(the_plan);
 	       printf("\n");
@@ -204,18 +254,206 @@ void setup(bench_problem *p)
 void doit(int iter, bench_problem *p)
 {
      int i;
-     FFTW(plan) q = the_plan;
+     FFTW(plan) q = (FFTW(plan)) p->userinfo;
 
-     UNUSED(p);
      for (i = 0; i < iter; ++i) 
-	  FFTW(execute)(q);
+	  execute_plan(q);
 }
 
-void done(bench_problem *p)
+void doit_shared(int iter, bench_problem *p, bench_problem *master)
+{
+     int i;
+     FFTW(plan) q = (FFTW(plan)) master->userinfo;
+
+     for (i = 0; i < iter; ++i) 
+	  execute_on(q, p);
+}
+
+/* pin the calling thread to the ITHR-th cpu that we may run on */
+static void pin_thread(int ithr)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+     cpu_set_t allowed, set;
+     int cpu, k;
+
+     if (sched_getaffinity(0, sizeof(allowed), &allowed))
+	  return;
+     k = ithr % CPU_COUNT(&allowed);
+     for (cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+	  if (CPU_ISSET(cpu, &allowed) && k-- == 0)
+	       break;
+     CPU_ZERO(&set);
+     CPU_SET(cpu, &set);
+     sched_setaffinity(0, sizeof(set), &set);
+#else
+     UNUSED(ithr);
+#endif
+}
+
+#if !defined(_OPENMP) && defined(HAVE_SMP) && defined(USING_POSIX_THREADS)
+/* the threads wait here until all of them are running */
+typedef struct {
+     pthread_mutex_t mutex;
+     pthread_cond_t cond;
+     int nready, go;
+} start_gate;
+
+typedef struct {
+     void (*proc)(int ithr, void *data);
+     void *data;
+     int ithr;
+     start_gate *gate;
+} thread_arg;
+
+static void *thread_main(void *arg_)
+{
+     thread_arg *arg = (thread_arg *) arg_;
+     start_gate *g = arg->gate;
+
+     pin_thread(arg->ithr);
+     pthread_mutex_lock(&g->mutex);
+     ++g->nready;
+     pthread_cond_broadcast(&g->cond);
+     while (!g->go)
+	  pthread_cond_wait(&g->cond, &g->mutex);
+     pthread_mutex_unlock(&g->mutex);
+
+     arg->proc(arg->ithr, arg->data);
+     return 0;
+}
+#endif
+
+/* Run PROC(i, DATA) for 0 <= i < NTHR, on NTHR pinned threads.  If
+   TIMED, return the time from the moment all threads are running and
+   pinned to the moment the last one finishes, which leaves out the
+   cost of creating them. */
+static double run_threads(int nthr, void (*proc)(int ithr, void *data),
+			  void *data, int timed)
+{
+     double t = 0.0;
+#if defined(_OPENMP)
+#  ifdef HAVE_SCHED_SETAFFINITY
+     /* thread 0 is us; don't leave ourselves pinned */
+     cpu_set_t mask;
+     int saved = !sched_getaffinity(0, sizeof(mask), &mask);
+#  endif
+
+#pragma omp parallel num_threads(nthr)
+     {
+	  int ithr = omp_get_thread_num();
+	  pin_thread(ithr);
+#pragma omp barrier
+#pragma omp master
+	  if (timed) timer_start(USER_TIMER);
+#pragma omp barrier
+	  proc(ithr, data);
+#pragma omp barrier
+#pragma omp master
+	  if (timed) t = timer_stop(USER_TIMER);
+     }
+
+#  ifdef HAVE_SCHED_SETAFFINITY
+     if (saved)
+	  sched_setaffinity(0, sizeof(mask), &mask);
+#  endif
+#elif defined(HAVE_SMP) && defined(USING_POSIX_THREADS)
+     int i;
+     pthread_t *tid;
+     thread_arg *arg;
+     start_gate g;
+
+     pthread_mutex_init(&g.mutex, 0);
+     pthread_cond_init(&g.cond, 0);
+     g.nready = g.go = 0;
+
+     tid = (pthread_t *) bench_malloc(nthr * sizeof(pthread_t));
+     arg = (thread_arg *) bench_malloc(nthr * sizeof(thread_arg));
+     for (i = 0; i < nthr; ++i) {
+	  arg[i].proc = proc;
+	  arg[i].data = data;
+	  arg[i].ithr = i;
+	  arg[i].gate = &g;
+	  BENCH_ASSERT(!pthread_create(tid + i, 0, thread_main, arg + i));
+     }
+
+     pthread_mutex_lock(&g.mutex);
+     while (g.nready < nthr)
+	  pthread_cond_wait(&g.cond, &g.mutex);
+     if (timed) timer_start(USER_TIMER);
+     g.go = 1;
+     pthread_cond_broadcast(&g.cond);
+     pthread_mutex_unlock(&g.mutex);
+
+     for (i = 0; i < nthr; ++i)
+	  pthread_join(tid[i], 0);
+     if (timed) t = timer_stop(USER_TIMER);
+
+     bench_free(arg);
+     bench_free(tid);
+     pthread_cond_destroy(&g.cond);
+     pthread_mutex_destroy(&g.mutex);
+#else
+     int i;
+
+     if (nthr > 1 && verbose > 1)
+	  fprintf(stderr, "bench: WARNING - no threads, running %d "
+		  "threads one after the other\n", nthr);
+     if (timed) timer_start(USER_TIMER);
+     for (i = 0; i < nthr; ++i)
+	  proc(i, data);
+     if (timed) t = timer_stop(USER_TIMER);
+#endif
+     return t;
+}
+
+double run_concurrently(int nthr, void (*proc)(int ithr, void *data),
+			void *data)
 {
-     UNUSED(p);
+     return run_threads(nthr, proc, data, 1);
+}
+
+#ifdef HAVE_SMP
+typedef struct {
+     void *(*work)(char *);
+     char *jobdata;
+     size_t elsize;
+} loop_jobs;
+
+static void run_job(int ithr, void *data)
+{
+     loop_jobs *j = (loop_jobs *) data;
+     j->work(j->jobdata + ithr * j->elsize);
+}
+
+/* the parallel loops of FFTW for -othreads-callback: one thread per
+   job, as an application scheduler might do */
+static void parallel_loop(void *(*work)(char *), char *jobdata,
+			  size_t elsize, int njobs, void *data)
+{
+     loop_jobs j;
+
+     UNUSED(data);
+     j.work = work;
+     j.jobdata = jobdata;
+     j.elsize = elsize;
+     run_threads(njobs, run_job, &j, 0);
+}
+#endif
 
-     FFTW(destroy_plan)(the_plan);
+void done(bench_problem *p)
+{
+     if (telemetry) {
+	  /* the plan, with the statistics of its threaded loops */
+	  FFTW(print_plan)((FFTW(plan)) p->userinfo);
+	  printf("\n");
+     }
+     if (memory_cap)
+	  FFTW(fprint_plan_memory_stats)(stdout);
+     FFTW(destroy_plan)((FFTW(plan)) p->userinfo);
+     if (the_plan == (FFTW(plan)) p->userinfo)
+	  the_plan = 0;
+     p->userinfo = 0;
+     plan_done(p);
      uninstall_hook();
 }
 
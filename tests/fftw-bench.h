@@ -2,6 +2,9 @@
    self-test/benchmark program (see bench.c). */
 
 #include "bench-user.h"
+#if defined(BENCHFFT_DDOUBLE)
+#define FFTW_DD_REAL bench_real
+#endif
 #include "fftw3.h"
 
 #define CONCAT(prefix, name) prefix ## name
@@ -11,6 +14,8 @@
 #define FFTW(x) CONCAT(fftwl_, x)
 #elif defined(BENCHFFT_QUAD)
 #define FFTW(x) CONCAT(fftwq_, x)
+#elif defined(BENCHFFT_DDOUBLE)
+#define FFTW(x) CONCAT(fftwdd_, x)
 #else
 #define FFTW(x) CONCAT(fftw_, x)
 #endif
@@ -21,10 +26,14 @@ extern "C"
 #endif /* __cplusplus */
 
 extern FFTW(plan) mkplan(bench_problem *p, unsigned flags);
+extern void execute_on(FFTW(plan) pln, bench_problem *p);
+extern void execute_plan(FFTW(plan) pln);
+extern void plan_done(bench_problem *p);
 extern void initial_cleanup(void);
 extern void final_cleanup(void);
 extern int import_wisdom(FILE *f);
 extern void export_wisdom(FILE *f);
+extern int split_phase;
 
 #if defined(HAVE_THREADS) || defined(HAVE_OPENMP)
 #  define HAVE_SMP
@@ -0,0 +1,43 @@
+/* Check the split of the twiddle pass of an hc2c transform among
+   threads (see threads/hc2c.c): the blocks cover all butterflies
+   exactly once, there are no more of them than threads, and every
+   block but the first starts at a multiple of 4 after butterfly 0. */
+
+#include <stdio.h>
+#define CALLING_FFTW /* hack for Windows DLL nonsense */
+#include "threads.h"
+
+static int check(INT mcount, int nthr)
+{
+     INT bs, b0, b1;
+     int i, nblocks = X(hc2c_split)(mcount, nthr, &bs);
+
+     if (nblocks < 1 || nblocks > nthr)
+	  goto bad;
+     if (X(hc2c_block_start)(mcount, nblocks, bs, 0) != 0
+	 || X(hc2c_block_start)(mcount, nblocks, bs, nblocks) != mcount)
+	  goto bad;
+     for (i = 0; i < nblocks; ++i) {
+	  b0 = X(hc2c_block_start)(mcount, nblocks, bs, i);
+	  b1 = X(hc2c_block_start)(mcount, nblocks, bs, i + 1);
+	  if (b1 <= b0 || (i > 0 && (b0 - 1) % 4 != 0))
+	       goto bad;
+     }
+     return 0;
+
+ bad:
+     printf("bad split of %ld butterflies among %d threads\n",
+	    (long) mcount, nthr);
+     return 1;
+}
+
+int main(void)
+{
+     INT mcount;
+     int nthr, fail = 0;
+
+     for (mcount = 2; mcount <= 300; ++mcount)
+	  for (nthr = 1; nthr <= 17; ++nthr)
+	       fail += check(mcount, nthr);
+     return fail != 0;
+}
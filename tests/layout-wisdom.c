@@ -0,0 +1,84 @@
+/* Check that the layout index of FFTW_WISDOM_LAYOUT survives a wisdom
+   export and import, that it is honoured, and that the plans made from
+   it are not recorded as wisdom of their own. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fftw-bench.h"
+
+#define N 64
+#define HOWMANY 4
+
+static int nsearches(void)
+{
+     FFTW(problem_stats) st[16];
+     int i, n = FFTW(planner_problem_stats)(st, 16), s = 0;
+     for (i = 0; i < n && i < 16; ++i)
+	  s += st[i].searches;
+     return s;
+}
+
+static FFTW(plan) mk(FFTW(complex) *in, FFTW(complex) *out, int dist,
+		     unsigned flags)
+{
+     int n = N;
+     return FFTW(plan_many_dft)(1, &n, HOWMANY, in, 0, 1, dist,
+				out, 0, 1, dist, FFTW_FORWARD, flags);
+}
+
+int main(void)
+{
+     const int dist0 = N, dist1 = N + 8;
+     FFTW(complex) *in, *out;
+     FFTW(plan) p;
+     char *w;
+     int fail = 0;
+
+     in = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex))
+					 * HOWMANY * dist1);
+     out = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex))
+					  * HOWMANY * dist1);
+
+     p = mk(in, out, dist0, FFTW_MEASURE | FFTW_WISDOM_LAYOUT);
+     FFTW(destroy_plan)(p);
+
+     w = FFTW(export_wisdom_to_string)();
+     if (!strstr(w, "(layout ")) {
+	  printf("layout index not exported\n");
+	  ++fail;
+     }
+
+     FFTW(forget_wisdom)();
+     if (!FFTW(import_wisdom_from_string)(w)) {
+	  printf("cannot import wisdom\n");
+	  ++fail;
+     }
+     free(w);
+
+     /* the padded variant is planned from the hints alone */
+     FFTW(reset_planner_stats)();
+     p = mk(in, out, dist1, FFTW_MEASURE | FFTW_WISDOM_LAYOUT);
+     if (!p) {
+	  printf("cannot plan the padded problem\n");
+	  ++fail;
+     } else
+	  FFTW(destroy_plan)(p);
+     if (nsearches() != 0) {
+	  printf("layout hint not honoured: %d searches\n", nsearches());
+	  ++fail;
+     }
+
+     /* ... but it has no wisdom of its own */
+     p = mk(in, out, dist1, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+     if (p) {
+	  printf("plan from a layout hint was recorded as wisdom\n");
+	  FFTW(destroy_plan)(p);
+	  ++fail;
+     }
+
+     FFTW(free)(out);
+     FFTW(free)(in);
+     FFTW(cleanup)();
+     return fail != 0;
+}
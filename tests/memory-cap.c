@@ -0,0 +1,80 @@
+/* Check that plans put to sleep by fftw_set_plan_memory_cap give the
+   same results when they are executed again, both while the cap is
+   set and after it has been lifted. */
+
+#include <stdio.h>
+#include <string.h>
+#include "fftw-bench.h"
+
+#define NPLANS 6
+#define NMAX (64 << NPLANS)
+
+static FFTW(complex) *in, *out;
+
+static void run(FFTW(plan) p, int n)
+{
+     int i;
+     for (i = 0; i < n; ++i) {
+	  in[i][0] = i % 7;
+	  in[i][1] = -(i % 5);
+     }
+     FFTW(execute)(p);
+}
+
+static int check(FFTW(plan) *p, FFTW(complex) **ref, const char *when)
+{
+     int k, fail = 0;
+
+     for (k = 0; k < NPLANS; ++k) {
+	  int n = 64 << k;
+	  run(p[k], n);
+	  if (memcmp(out, ref[k], n * sizeof(FFTW(complex)))) {
+	       printf("plan %d: wrong output %s\n", k, when);
+	       ++fail;
+	  }
+     }
+     return fail;
+}
+
+int main(void)
+{
+     FFTW(plan) p[NPLANS];
+     FFTW(complex) *ref[NPLANS];
+     FFTW(memory_stats) st;
+     int k, fail = 0;
+
+     in = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * NMAX);
+     out = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * NMAX);
+
+     for (k = 0; k < NPLANS; ++k) {
+	  int n = 64 << k;
+	  p[k] = FFTW(plan_dft_1d)(n, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+	  ref[k] = (FFTW(complex) *)
+	       FFTW(malloc)(sizeof(FFTW(complex)) * n);
+	  run(p[k], n);
+	  memcpy(ref[k], out, n * sizeof(FFTW(complex)));
+     }
+
+     /* a cap that no plan fits in: every plan but the one being
+	executed is put to sleep */
+     FFTW(set_plan_memory_cap)(1);
+     FFTW(plan_memory_stats)(&st);
+     if (st.asleep == 0) {
+	  printf("no plan was put to sleep\n");
+	  ++fail;
+     }
+     fail += check(p, ref, "under the cap");
+
+     /* the plans that are asleep now must wake up by themselves */
+     FFTW(set_plan_memory_cap)(0);
+     fail += check(p, ref, "after lifting the cap");
+
+     for (k = 0; k < NPLANS; ++k) {
+	  FFTW(destroy_plan)(p[k]);
+	  FFTW(free)(ref[k]);
+     }
+     FFTW(free)(out);
+     FFTW(free)(in);
+     FFTW(cleanup)();
+     return fail != 0;
+}
@@ -0,0 +1,145 @@
+/* Check FFTW_PACKED transforms of even and odd sizes, of rank 1 to 3,
+   against the padded r2c transform: the complex columns of the packed
+   output must be those of the padded output, the one or two real
+   columns the R2HC transform of the sums of the rows, and the packed
+   c2r transform must return N times the input.  The guru planners
+   ignore FFTW_PACKED and make padded transforms. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fftw-bench.h"
+
+static const int cases[][4] = { /* rank, then the size */
+     {1, 16}, {1, 15}, {2, 6, 10}, {2, 5, 7}, {3, 4, 6, 8}, {3, 3, 5, 9}
+};
+#define NCASES ((int) (sizeof(cases) / sizeof(cases[0])))
+
+static double tol(void)
+{
+     return sizeof(bench_real) == sizeof(float) ? 1e-4 : 1e-10;
+}
+
+static int check(int d, const int *n)
+{
+     FFTW(plan) padded, guru, packed, back, cols;
+     FFTW(iodim) dims[3];
+     FFTW(r2r_kind) kinds[3];
+     bench_real *x, *xp, *a, *v;
+     FFTW(complex) *y, *yg;
+     int i, j, k, r, c, N = 1, m, mh, R, is, os, fail = 0;
+     double err = 0.0;
+
+     for (i = 0; i < d; ++i)
+	  N *= n[i];
+     m = n[d - 1];
+     mh = m / 2 + 1;
+     R = N / m;
+
+     x = (bench_real *) FFTW(malloc)(sizeof(bench_real) * N);
+     xp = (bench_real *) FFTW(malloc)(sizeof(bench_real) * N);
+     a = (bench_real *) FFTW(malloc)(sizeof(bench_real) * N);
+     v = (bench_real *) FFTW(malloc)(sizeof(bench_real) * R);
+     y = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * R * mh);
+     yg = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex)) * R * mh);
+
+     for (i = d - 1, is = 1, os = 1; i >= 0; --i) {
+	  dims[i].n = n[i];
+	  dims[i].is = is;
+	  dims[i].os = os;
+	  is *= n[i];
+	  os *= i == d - 1 ? mh : n[i];
+	  kinds[i] = FFTW_R2HC;
+     }
+
+     padded = FFTW(plan_dft_r2c)(d, n, xp, y, FFTW_ESTIMATE);
+     guru = FFTW(plan_guru_dft_r2c)(d, dims, 0, 0, xp, yg,
+				    FFTW_ESTIMATE | FFTW_PACKED);
+     packed = FFTW(plan_dft_r2c)(d, n, a, (FFTW(complex) *) a,
+				 FFTW_ESTIMATE | FFTW_PACKED);
+     back = FFTW(plan_dft_c2r)(d, n, (FFTW(complex) *) a, a,
+			       FFTW_ESTIMATE | FFTW_PACKED);
+     cols = FFTW(plan_r2r)(d - 1, n, v, v, kinds, FFTW_ESTIMATE);
+     if (!padded || !guru || !packed || !back || !cols) {
+	  printf("cannot plan size %d of rank %d\n", N, d);
+	  fail = 1;
+	  goto done;
+     }
+
+     for (i = 0; i < N; ++i)
+	  x[i] = (rand() % 2001 - 1000) / 1000.0;
+
+     for (i = 0; i < N; ++i)
+	  xp[i] = x[i];
+     FFTW(execute)(padded);
+     for (i = 0; i < N; ++i)
+	  xp[i] = x[i];
+     FFTW(execute)(guru);
+     for (i = 0; i < R * mh; ++i)
+	  for (c = 0; c < 2; ++c)
+	       err = fmax(err, fabs((double) (yg[i][c] - y[i][c])));
+     if (err > tol() * N) {
+	  printf("guru plan for size %d of rank %d is not padded\n", N, d);
+	  fail = 1;
+     }
+
+     for (i = 0; i < N; ++i)
+	  a[i] = x[i];
+     FFTW(execute)(packed);
+
+     /* the complex columns */
+     for (err = 0.0, r = 0; r < R; ++r)
+	  for (k = 1; 2 * k < m; ++k)
+	       for (c = 0; c < 2; ++c)
+		    err = fmax(err, fabs((double) (a[r * m + 2 * k - (m & 1) + c]
+						   - y[r * mh + k][c])));
+
+     /* the real columns: k = 0 in element 0 and, for even m, k = m/2
+	in element 1 of every row */
+     for (k = 0; k < 2 - (m & 1); ++k) {
+	  for (r = 0; r < R; ++r) {
+	       v[r] = 0;
+	       for (j = 0; j < m; ++j)
+		    v[r] += (k && (j & 1)) ? -x[r * m + j] : x[r * m + j];
+	  }
+	  FFTW(execute)(cols);
+	  for (r = 0; r < R; ++r)
+	       err = fmax(err, fabs((double) (a[r * m + k] - v[r])));
+     }
+     if (err > tol() * N) {
+	  printf("packed r2c of size %d, rank %d: error %g\n", N, d, err);
+	  fail = 1;
+     }
+
+     FFTW(execute)(back);
+     for (err = 0.0, i = 0; i < N; ++i)
+	  err = fmax(err, fabs((double) (a[i] - x[i] * N)));
+     if (err > tol() * N) {
+	  printf("packed c2r of size %d, rank %d: error %g\n", N, d, err);
+	  fail = 1;
+     }
+
+ done:
+     FFTW(destroy_plan)(cols);
+     FFTW(destroy_plan)(back);
+     FFTW(destroy_plan)(packed);
+     FFTW(destroy_plan)(guru);
+     FFTW(destroy_plan)(padded);
+     FFTW(free)(yg);
+     FFTW(free)(y);
+     FFTW(free)(v);
+     FFTW(free)(a);
+     FFTW(free)(xp);
+     FFTW(free)(x);
+     return fail;
+}
+
+int main(void)
+{
+     int i, fail = 0;
+
+     for (i = 0; i < NCASES; ++i)
+	  fail += check(cases[i][0], cases[i] + 1);
+     FFTW(cleanup)();
+     return fail != 0;
+}
@@ -0,0 +1,316 @@
+#! /usr/bin/perl -w
+
+# Performance regression tracking.
+#
+#   perfcheck.pl [options] --run=FILE [path/to/bench]
+#
+# times a canonical set of problems and stores all the repeated
+# measurements, together with a fingerprint of the machine and of
+# the build, in FILE.
+#
+#   perfcheck.pl [options] --compare OLD NEW
+#
+# compares two such files problem by problem, and reports the
+# differences that are statistically significant.  The exit status
+# is 1 if any problem got slower.
+
+$program = "./bench";
+$default_options = "";
+$verbose = 0;
+$patient = 0;
+$estimate = 0;
+$nthreads = 1;
+$repeat = 10;
+$time_min = 0;
+$maxsize = 1048576;
+$output = "";
+$compare = 0;
+$alpha = 0.01;
+$threshold = 0.05;
+@files = ();
+
+# the sizes of tools/fftw-wisdom --canonical
+@canonical_1d = (1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024,
+		 2048, 4096, 8192, 16384, 32768, 65536, 131072,
+		 262144, 524288, 1048576,
+		 10, 100, 1000, 10000, 100000, 1000000);
+@canonical_nd = ("2x2", "4x4", "8x8", "10x10", "16x16", "32x32", "64x64",
+		 "100x100", "128x128", "256x256", "512x512", "1000x1000",
+		 "1024x1024", "2x2x2", "4x4x4", "8x8x8", "10x10x10",
+		 "16x16x16", "32x32x32", "64x64x64", "100x100x100");
+
+sub make_options {
+    my $nthr = shift;
+    my $options = $default_options;
+    $options = "--time-repeat=$repeat $options";
+    $options = "--time-min=$time_min $options" if $time_min;
+    $options = "-o patient $options" if $patient;
+    $options = "-o estimate $options" if $estimate;
+    $options = "-o nthreads=$nthr $options" if ($nthr > 1);
+    return $options;
+}
+
+sub total_size {
+    my $sz = shift;
+    my $n = 1;
+    for (split /x/, $sz) { $n *= $_; }
+    return $n;
+}
+
+# complex and real transforms of all the canonical sizes, r2r
+# transforms and batches of the 1d ones, and the large ones again
+# with threads
+sub canonical_problems {
+    my @probs = ();
+    my $sz;
+
+    for $sz (@canonical_1d, @canonical_nd) {
+	next if (total_size($sz) > $maxsize);
+	push @probs, [1, "ocf$sz"], [1, "icb$sz"];
+	push @probs, [1, "orf$sz"], [1, "orb$sz"] if (total_size($sz) > 1);
+    }
+
+    for $sz (@canonical_1d) {
+	next if ($sz < 4 || $sz > $maxsize);
+	push @probs, [1, "ok${sz}e10"], [1, "ok${sz}h"];
+	if ($sz <= 1024) {
+	    my $v = int(65536 / $sz);
+	    push @probs, [1, "icf${sz}*${v}"], [1, "orf${sz}v${v}"];
+	}
+    }
+
+    if ($nthreads > 1) {
+	for $sz (@canonical_1d, @canonical_nd) {
+	    next if (total_size($sz) < 65536 || total_size($sz) > $maxsize);
+	    push @probs, [$nthreads, "icf$sz"], [$nthreads, "orf$sz"];
+	}
+    }
+
+    return @probs;
+}
+
+sub fingerprint {
+    my @fp = ();
+    my $line;
+
+    push @fp, "date " . localtime();
+    for $line (`$program --info-all`) {
+	push @fp, "$1 $2" if ($line =~ /^\((\S+) "(.*)"\)$/);
+    }
+    chomp($line = `uname -a 2>/dev/null`);
+    push @fp, "uname $line" if $line;
+    chomp($line = `hostname 2>/dev/null`);
+    push @fp, "hostname $line" if $line;
+    if (open(CPUINFO, "/proc/cpuinfo")) {
+	my $ncpu = 0;
+	my $model = "";
+	while (<CPUINFO>) {
+	    ++$ncpu if /^processor\s*:/;
+	    $model = $1 if (!$model && /^model name\s*:\s*(.*)$/);
+	}
+	close(CPUINFO);
+	push @fp, "cpu $model" if $model;
+	push @fp, "ncpu $ncpu";
+    }
+    push @fp, "bench-options " . make_options(1);
+    return @fp;
+}
+
+# run the problems of one thread count in a single bench invocation
+sub time_problems {
+    my ($nthr, @probs) = @_;
+    my $options = make_options($nthr);
+    my @ok = ();
+    my @result = ();
+    my ($i, $line);
+
+    return () if ($#probs < 0);
+
+    my $cmd = "$program $options " . join(" ", map { "--can-do '$_'" } @probs);
+    my @cando = `$cmd`;
+    for ($i = 0; $i <= $#probs; ++$i) {
+	if ($cando[$i] =~ /#t/) {
+	    push @ok, $probs[$i];
+	} elsif ($verbose) {
+	    print "skipping $probs[$i]\n";
+	}
+    }
+    return () if ($#ok < 0);
+
+    $cmd = "$program $options --report-samples " .
+	join(" ", map { "-s '$_'" } @ok);
+    print "Executing \"$cmd\"\n" if $verbose;
+    my @out = `$cmd`;
+    die "bench failed\n" if ($? != 0 || $#out != $#ok);
+
+    for ($i = 0; $i <= $#ok; ++$i) {
+	($line = $out[$i]) =~ s/^\((.*)\)\s*$/$1/;
+	push @result, "$ok[$i] $nthr $line";
+	print "$ok[$i] $nthr $line\n" if $verbose;
+    }
+    return @result;
+}
+
+sub run {
+    my @probs = canonical_problems();
+    my %bythreads = ();
+    my ($p, $nthr);
+
+    for $p (@probs) {
+	push @{$bythreads{$p->[0]}}, $p->[1];
+    }
+
+    open(OUT, ">$output") || die "cannot open $output\n";
+    print OUT "# fftw perfcheck results\n";
+    print OUT "# $_\n" for (fingerprint());
+    for $nthr (sort { $a <=> $b } keys %bythreads) {
+	print OUT "$_\n" for (time_problems($nthr, @{$bythreads{$nthr}}));
+    }
+    close(OUT);
+}
+
+sub read_results {
+    my $fname = shift;
+    my %samples = ();
+    my %fp = ();
+
+    open(IN, $fname) || die "cannot open $fname\n";
+    while (<IN>) {
+	chomp;
+	if (/^# (\S+) (.*)$/) {
+	    $fp{$1} = $2;
+	} elsif (/^(\S+) (\d+) (.*)$/) {
+	    $samples{"$1 $2"} = [split(/ /, $3)];
+	}
+    }
+    close(IN);
+    return (\%samples, \%fp);
+}
+
+sub median {
+    my @s = sort { $a <=> $b } @_;
+    my $n = $#s + 1;
+    return ($n % 2) ? $s[($n - 1) / 2] : 0.5 * ($s[$n / 2 - 1] + $s[$n / 2]);
+}
+
+# erfc, Abramowitz and Stegun 7.1.26 (error < 1.5e-7)
+sub erfc {
+    my $x = shift;
+    my $z = abs($x);
+    my $t = 1.0 / (1.0 + 0.3275911 * $z);
+    my $y = $t * (0.254829592 + $t * (-0.284496736 + $t * (1.421413741
+	    + $t * (-1.453152027 + $t * 1.061405429)))) * exp(-$z * $z);
+    return ($x >= 0) ? $y : 2.0 - $y;
+}
+
+# two-sided p-value of the Mann-Whitney U test, by the normal
+# approximation with tie correction
+sub mann_whitney {
+    my ($x, $y) = @_;
+    my $n1 = $#$x + 1;
+    my $n2 = $#$y + 1;
+    my $n = $n1 + $n2;
+    my @all = sort { $a->[0] <=> $b->[0] }
+	((map { [$_, 0] } @$x), (map { [$_, 1] } @$y));
+    my ($i, $j, $r1, $ties) = (0, 0, 0, 0);
+
+    while ($i < $n) {
+	for ($j = $i; $j + 1 < $n && $all[$j + 1]->[0] == $all[$i]->[0]; ++$j) {}
+	my $rank = 0.5 * ($i + $j) + 1;
+	my $t = $j - $i + 1;
+	$ties += $t * $t * $t - $t;
+	for (; $i <= $j; ++$i) {
+	    $r1 += $rank if ($all[$i]->[1] == 0);
+	}
+    }
+
+    my $u = $r1 - $n1 * ($n1 + 1) / 2;
+    my $mu = $n1 * $n2 / 2;
+    my $var = $n1 * $n2 / 12 * (($n + 1) - $ties / ($n * ($n - 1)));
+    return 1.0 if ($var <= 0);
+    my $z = (abs($u - $mu) - 0.5) / sqrt($var);
+    return 1.0 if ($z <= 0);
+    return erfc($z / sqrt(2));
+}
+
+sub compare {
+    my ($old, $oldfp) = read_results($files[0]);
+    my ($new, $newfp) = read_results($files[1]);
+    my ($key, $k);
+    my ($nslower, $nfaster, $ncommon, $logsum) = (0, 0, 0, 0);
+
+    for $k ("cpu", "ncpu", "hostname", "version", "cc", "codelet-optim",
+	    "benchmark-precision", "bench-options") {
+	my $va = defined($oldfp->{$k}) ? $oldfp->{$k} : "?";
+	my $vb = defined($newfp->{$k}) ? $newfp->{$k} : "?";
+	print "note: $k differs: \"$va\" vs. \"$vb\"\n" if ($va ne $vb);
+    }
+
+    for $key (sort keys %$old) {
+	next if (!defined($new->{$key}));
+	my ($prob, $nthr) = split(/ /, $key);
+	my $m0 = median(@{$old->{$key}});
+	my $m1 = median(@{$new->{$key}});
+	next if ($m0 <= 0 || $m1 <= 0);
+	my $ratio = $m1 / $m0;
+	my $p = mann_whitney($old->{$key}, $new->{$key});
+	my $what = "";
+
+	++$ncommon;
+	$logsum += log($ratio);
+	if ($p < $alpha && $ratio > 1 + $threshold) {
+	    $what = "SLOWER";
+	    ++$nslower;
+	} elsif ($p < $alpha && $ratio < 1 - $threshold) {
+	    $what = "faster";
+	    ++$nfaster;
+	}
+	printf("%-24s %3d threads: %.4g -> %.4g s, ratio %.3f, p = %.2g %s\n",
+	       $prob, $nthr, $m0, $m1, $ratio, $p, $what)
+	    if ($what || $verbose);
+    }
+
+    die "no problems in common\n" if (!$ncommon);
+    printf("%d problems compared: %d slower, %d faster, " .
+	   "geometric mean time ratio %.3f\n",
+	   $ncommon, $nslower, $nfaster, exp($logsum / $ncommon));
+    return $nslower;
+}
+
+sub parse_arguments (@)
+{
+    local (@arglist) = @_;
+
+    while (@arglist)
+    {
+	if ($arglist[0] eq '-v') { ++$verbose; }
+	elsif ($arglist[0] eq '--verbose') { ++$verbose; }
+	elsif ($arglist[0] eq '--patient') { ++$patient; }
+	elsif ($arglist[0] eq '--estimate') { ++$estimate; }
+	elsif ($arglist[0] =~ /^--nthreads=(.+)$/) { $nthreads = $1; }
+	elsif ($arglist[0] =~ /^--repeat=(.+)$/) { $repeat = $1; }
+	elsif ($arglist[0] =~ /^--time-min=(.+)$/) { $time_min = $1; }
+	elsif ($arglist[0] =~ /^--maxsize=(.+)$/) { $maxsize = $1; }
+	elsif ($arglist[0] =~ /^--run=(.+)$/) { $output = $1; }
+	elsif ($arglist[0] eq '--compare') { ++$compare; }
+	elsif ($arglist[0] =~ /^--alpha=(.+)$/) { $alpha = $1; }
+	elsif ($arglist[0] =~ /^--threshold=(.+)$/) { $threshold = $1; }
+	elsif ($compare) { push @files, $arglist[0]; }
+	else { $program=$arglist[0]; }
+	shift (@arglist);
+    }
+}
+
+# MAIN PROGRAM:
+
+&parse_arguments (@ARGV);
+
+if ($compare) {
+    die "usage: perfcheck.pl --compare OLD NEW\n" if ($#files != 1);
+    exit(&compare ? 1 : 0);
+} elsif ($output) {
+    &run;
+} else {
+    die "usage: perfcheck.pl [options] --run=FILE [bench] | " .
+	"--compare OLD NEW\n";
+}
@@ -0,0 +1,171 @@
+/* Check that a polyphase filter bank gives the same spectra whether
+   a stream is fed to it in one execution or in several smaller ones
+   (with the new-array execute functions, on arrays that alternate),
+   and that these are the DFTs of the windowed and folded stream
+   computed directly.  With threads, this is done both with one
+   thread and with several. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fftw-bench.h"
+
+#define K2PI 6.2831853071795864769252867665590057683943388
+
+static double tol(void)
+{
+     return sizeof(bench_real) == sizeof(float) ? 1e-4 : 1e-10;
+}
+
+/* the largest error of the NS spectra OUT, starting at spectrum G0
+   of the stream X (complex, or real if !CPLX) of M channels filtered
+   by the TAPS x M coefficients H */
+static double check(int m, int taps, const bench_real *h,
+		    const bench_real *x, int cplx, int g0, int ns,
+		    const FFTW(complex) *out)
+{
+     int nout = cplx ? m : m / 2 + 1, g, t, k, q;
+     double *y = (double *) malloc(sizeof(double) * 2 * m), err = 0.0;
+
+     for (g = g0; g < g0 + ns; ++g) {
+	  for (k = 0; k < m; ++k) {
+	       y[2 * k] = y[2 * k + 1] = 0.0;
+	       for (t = 0; t < taps; ++t) {
+		    int j = (g + t - (taps - 1)) * m + k;
+		    if (j < 0)
+			 continue;
+		    if (cplx) {
+			 y[2 * k] += (double) h[t * m + k] * (double) x[2 * j];
+			 y[2 * k + 1] +=
+			      (double) h[t * m + k] * (double) x[2 * j + 1];
+		    } else
+			 y[2 * k] += (double) h[t * m + k] * (double) x[j];
+	       }
+	  }
+	  for (q = 0; q < nout; ++q) {
+	       double re = 0.0, im = 0.0;
+	       for (k = 0; k < m; ++k) {
+		    double a = -K2PI * ((k * q) % m) / m;
+		    re += y[2 * k] * cos(a) - y[2 * k + 1] * sin(a);
+		    im += y[2 * k] * sin(a) + y[2 * k + 1] * cos(a);
+	       }
+	       t = (g - g0) * nout + q;
+	       err = fmax(err, fabs(re - (double) out[t][0]));
+	       err = fmax(err, fabs(im - (double) out[t][1]));
+	  }
+     }
+     free(y);
+     return err;
+}
+
+static FFTW(plan) mkpfb(int m, int taps, const bench_real *h, int ns,
+			bench_real *in, FFTW(complex) *out, int cplx)
+{
+     if (cplx)
+	  return FFTW(plan_pfb_dft)(m, taps, h, ns, (FFTW(complex) *) in,
+				    out, FFTW_FORWARD, FFTW_ESTIMATE);
+     return FFTW(plan_pfb_r2c)(m, taps, h, ns, in, out, FFTW_ESTIMATE);
+}
+
+/* feed NS * NPIECES spectra of M channels to a filter bank of TAPS
+   taps, in one execution and in NPIECES of them */
+static int run(int m, int taps, int ns, int npieces, int cplx)
+{
+     int nr = cplx ? 2 : 1, nout = cplx ? m : m / 2 + 1;
+     int nx = ns * npieces * m, i, j, fail = 0;
+     bench_real *h, *x, *pin[2];
+     FFTW(complex) *out, *pout[2];
+     FFTW(plan) whole, piece;
+     double err;
+
+     h = (bench_real *) FFTW(malloc)(sizeof(bench_real) * taps * m);
+     x = (bench_real *) FFTW(malloc)(sizeof(bench_real) * nr * nx);
+     out = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex))
+					  * ns * npieces * nout);
+     for (i = 0; i < 2; ++i) {
+	  pin[i] = (bench_real *) FFTW(malloc)(sizeof(bench_real)
+					       * nr * ns * m);
+	  pout[i] = (FFTW(complex) *) FFTW(malloc)(sizeof(FFTW(complex))
+						   * ns * nout);
+     }
+
+     for (j = 0; j < taps * m; ++j)
+	  h[j] = cos(0.1 * j) + 0.01 * j;
+     for (j = 0; j < nr * nx; ++j)
+	  x[j] = (rand() % 2001 - 1000) / 1000.0;
+
+     whole = mkpfb(m, taps, h, ns * npieces, x, out, cplx);
+     piece = mkpfb(m, taps, h, ns, pin[0], pout[0], cplx);
+     if (!whole || !piece) {
+	  printf("cannot plan a filter bank of %d channels\n", m);
+	  fail = 1;
+	  goto done;
+     }
+
+     FFTW(execute)(whole);
+     err = check(m, taps, h, x, cplx, 0, ns * npieces, out);
+     if (err > tol() * taps * m) {
+	  printf("%d channels, %d taps, %d spectra: error %g\n",
+		 m, taps, ns * npieces, err);
+	  fail = 1;
+     }
+
+     for (i = 0; i < npieces; ++i) {
+	  bench_real *in = pin[i & 1];
+	  FFTW(complex) *o = pout[i & 1];
+
+	  for (j = 0; j < nr * ns * m; ++j)
+	       in[j] = x[i * nr * ns * m + j];
+	  if (cplx)
+	       FFTW(execute_dft)(piece, (FFTW(complex) *) in, o);
+	  else
+	       FFTW(execute_dft_r2c)(piece, in, o);
+
+	  err = check(m, taps, h, x, cplx, i * ns, ns, o);
+	  if (err > tol() * taps * m) {
+	       printf("%d channels, %d taps, piece %d of %d spectra: "
+		      "error %g\n", m, taps, i, ns, err);
+	       fail = 1;
+	  }
+     }
+
+ done:
+     FFTW(destroy_plan)(piece);
+     FFTW(destroy_plan)(whole);
+     for (i = 0; i < 2; ++i) {
+	  FFTW(free)(pout[i]);
+	  FFTW(free)(pin[i]);
+     }
+     FFTW(free)(out);
+     FFTW(free)(x);
+     FFTW(free)(h);
+     return fail;
+}
+
+static int run_all(void)
+{
+     int fail = 0;
+
+     fail += run(15, 4, 40, 3, 1);
+     fail += run(16, 3, 50, 4, 0);
+     fail += run(15, 5, 33, 3, 0);
+     /* pieces with fewer spectra than taps */
+     fail += run(8, 5, 2, 7, 1);
+     fail += run(9, 6, 3, 5, 0);
+     return fail;
+}
+
+int main(void)
+{
+     int fail = run_all();
+
+#ifdef HAVE_SMP
+     if (FFTW(init_threads)()) {
+	  FFTW(plan_with_nthreads)(3);
+	  fail += run_all();
+	  FFTW(cleanup_threads)();
+     }
+#endif
+     FFTW(cleanup)();
+     return fail != 0;
+}
@@ -0,0 +1,180 @@
+/* Check fftw_plan_dft_axes and fftw_plan_r2r_axes: for transforms of
+   a three-dimensional array along no axis, a middle axis, and negative
+   and reordered axes, they must give the same outputs as the guru
+   plans with the transformed dimensions as dims and the others as
+   howmany_dims.  Repeated and out-of-range axes must be refused. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fftw-bench.h"
+
+#define RANK 3
+static const int n[RANK] = { 6, 5, 4 };
+#define N (6 * 5 * 4)
+
+static const struct {
+     int naxes;
+     int axes[RANK];
+} cases[] = {
+     { 0, { 0 } },
+     { 1, { 1 } },
+     { 1, { -1 } },
+     { 2, { -3, -1 } },
+     { 2, { 2, 0 } },
+     { 3, { -2, 0, -1 } }
+};
+#define NCASES ((int) (sizeof(cases) / sizeof(cases[0])))
+
+/* the kind of r2r transform along each axis */
+static const FFTW(r2r_kind) kinds[RANK] = {
+     FFTW_REDFT10, FFTW_RODFT00, FFTW_R2HC
+};
+
+static double tol(void)
+{
+     return sizeof(bench_real) == sizeof(float) ? 1e-4 : 1e-10;
+}
+
+/* the guru dims of the transform along AXES of the row-major array
+   of size n, with S the stride of its last dimension */
+static int mkdims(int naxes, const int *axes, int s,
+		  FFTW(iodim) *dims, FFTW(iodim) *hdims)
+{
+     int stride[RANK], transformed[RANK];
+     int i, a, h = 0;
+
+     for (i = RANK - 1; i >= 0; --i) {
+	  stride[i] = s;
+	  s *= n[i];
+	  transformed[i] = 0;
+     }
+     for (i = 0; i < naxes; ++i) {
+	  a = axes[i] < 0 ? axes[i] + RANK : axes[i];
+	  transformed[a] = 1;
+	  dims[i].n = n[a];
+	  dims[i].is = dims[i].os = stride[a];
+     }
+     for (i = 0; i < RANK; ++i)
+	  if (!transformed[i]) {
+	       hdims[h].n = n[i];
+	       hdims[h].is = hdims[h].os = stride[i];
+	       ++h;
+	  }
+     return h;
+}
+
+static void describe(int c)
+{
+     int i;
+     printf("axes {");
+     for (i = 0; i < cases[c].naxes; ++i)
+	  printf(i ? ", %d" : "%d", cases[c].axes[i]);
+     printf("}");
+}
+
+/* compare the plan P with the guru plan REF, from I to O and from
+   IREF to OREF, on NR reals of input and output */
+static int compare(FFTW(plan) p, FFTW(plan) ref, bench_real *I,
+		   bench_real *O, bench_real *Iref, bench_real *Oref,
+		   int nr, const char *what, int c)
+{
+     double err = 0.0;
+     int i;
+
+     if (!p || !ref) {
+	  printf("%s along ", what);
+	  describe(c);
+	  printf(": cannot plan%s\n", p ? " the guru transform" : "");
+	  return 1;
+     }
+     for (i = 0; i < nr; ++i) {
+	  I[i] = Iref[i] = (rand() % 2001 - 1000) / 1000.0;
+	  O[i] = Oref[i] = 0.0;
+     }
+     FFTW(execute)(p);
+     FFTW(execute)(ref);
+     for (i = 0; i < nr; ++i)
+	  err = fmax(err, fabs((double) (O[i] - Oref[i])));
+     if (err > tol() * N) {
+	  printf("%s along ", what);
+	  describe(c);
+	  printf(": error %g\n", err);
+	  return 1;
+     }
+     return 0;
+}
+
+static int check(int c)
+{
+     int naxes = cases[c].naxes;
+     const int *axes = cases[c].axes;
+     bench_real *I, *O, *Iref, *Oref;
+     FFTW(iodim) dims[RANK], hdims[RANK];
+     FFTW(r2r_kind) k[RANK];
+     FFTW(plan) p, ref;
+     int h, i, fail = 0;
+
+     I = (bench_real *) FFTW(malloc)(sizeof(bench_real) * 2 * N);
+     O = (bench_real *) FFTW(malloc)(sizeof(bench_real) * 2 * N);
+     Iref = (bench_real *) FFTW(malloc)(sizeof(bench_real) * 2 * N);
+     Oref = (bench_real *) FFTW(malloc)(sizeof(bench_real) * 2 * N);
+
+     h = mkdims(naxes, axes, 1, dims, hdims);
+     p = FFTW(plan_dft_axes)(RANK, n, naxes, axes,
+			     (FFTW(complex) *) I, (FFTW(complex) *) O,
+			     FFTW_FORWARD, FFTW_ESTIMATE);
+     ref = FFTW(plan_guru_dft)(naxes, dims, h, hdims,
+			       (FFTW(complex) *) Iref, (FFTW(complex) *) Oref,
+			       FFTW_FORWARD, FFTW_ESTIMATE);
+     fail += compare(p, ref, I, O, Iref, Oref, 2 * N, "dft", c);
+     FFTW(destroy_plan)(ref);
+     FFTW(destroy_plan)(p);
+
+     for (i = 0; i < naxes; ++i)
+	  k[i] = kinds[axes[i] < 0 ? axes[i] + RANK : axes[i]];
+     p = FFTW(plan_r2r_axes)(RANK, n, naxes, axes, I, O, k, FFTW_ESTIMATE);
+     ref = FFTW(plan_guru_r2r)(naxes, dims, h, hdims, Iref, Oref, k,
+			       FFTW_ESTIMATE);
+     fail += compare(p, ref, I, O, Iref, Oref, N, "r2r", c);
+     FFTW(destroy_plan)(ref);
+     FFTW(destroy_plan)(p);
+
+     FFTW(free)(Oref);
+     FFTW(free)(Iref);
+     FFTW(free)(O);
+     FFTW(free)(I);
+     return fail;
+}
+
+static int check_refused(void)
+{
+     static const int repeated[] = { 1, -2 }, outside[] = { 3 };
+     bench_real *I = (bench_real *) FFTW(malloc)(sizeof(bench_real) * 2 * N);
+     FFTW(plan) p, q;
+     int fail = 0;
+
+     p = FFTW(plan_dft_axes)(RANK, n, 2, repeated, (FFTW(complex) *) I,
+			     (FFTW(complex) *) I, FFTW_FORWARD, FFTW_ESTIMATE);
+     q = FFTW(plan_r2r_axes)(RANK, n, 1, outside, I, I, kinds,
+			     FFTW_ESTIMATE);
+     if (p || q) {
+	  printf("%s axes accepted\n", p ? "repeated" : "out-of-range");
+	  fail = 1;
+     }
+     FFTW(destroy_plan)(q);
+     FFTW(destroy_plan)(p);
+     FFTW(free)(I);
+     return fail;
+}
+
+int main(void)
+{
+     int c, fail = 0;
+
+     for (c = 0; c < NCASES; ++c)
+	  fail += check(c);
+     fail += check_refused();
+     FFTW(cleanup)();
+     return fail != 0;
+}
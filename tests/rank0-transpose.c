@@ -0,0 +1,135 @@
+/* Check rank-0 transposes: X(cpynd) must move every run of VL reals
+   of a three-dimensional array to its place in each permutation of
+   the array, with ordinary and with non-temporal stores, and the
+   planner must make correct plans for the same transposes given as
+   rank-0 guru r2r problems. */
+
+#include <stdio.h>
+#define CALLING_FFTW /* hack for Windows DLL nonsense */
+#include "api.h"
+
+static const int perms[][3] = {
+     {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+};
+#define NPERMS ((int) (sizeof(perms) / sizeof(perms[0])))
+
+static const int sizes[][3] = { {37, 29, 23}, {64, 32, 16} };
+#define NSIZES ((int) (sizeof(sizes) / sizeof(sizes[0])))
+
+/* the dimensions of the transpose of the N0 x N1 x N2 array of runs
+   of VL reals into the order PERM, by decreasing output stride */
+static void mkdims(const int *n, const int *perm, INT vl, iodim *d)
+{
+     INT is[3], os = vl;
+     int k;
+
+     is[2] = vl;
+     is[1] = is[2] * n[2];
+     is[0] = is[1] * n[1];
+     for (k = 2; k >= 0; --k) {
+	  d[k].n = n[perm[k]];
+	  d[k].is = is[perm[k]];
+	  d[k].os = os;
+	  os *= n[perm[k]];
+     }
+}
+
+/* the number of reals of O that are not those of I moved by D */
+static int verify(const R *I, const R *O, const iodim *d, INT vl)
+{
+     INT i0, i1, i2, v;
+     int bad = 0;
+
+     for (i0 = 0; i0 < d[0].n; ++i0)
+	  for (i1 = 0; i1 < d[1].n; ++i1)
+	       for (i2 = 0; i2 < d[2].n; ++i2)
+		    for (v = 0; v < vl; ++v)
+			 if (O[i0 * d[0].os + i1 * d[1].os + i2 * d[2].os + v]
+			     != I[i0 * d[0].is + i1 * d[1].is + i2 * d[2].is + v])
+			      ++bad;
+     return bad;
+}
+
+static int check_cpynd(const int *n, const int *perm, INT vl, int nt)
+{
+     INT N = n[0] * n[1] * n[2] * vl, i;
+     R *I = (R *) MALLOC(sizeof(R) * N, OTHER);
+     R *O = (R *) MALLOC(sizeof(R) * N, OTHER);
+     iodim d[3];
+     int bad;
+
+     for (i = 0; i < N; ++i) {
+	  I[i] = (double) i;
+	  O[i] = -1.0;
+     }
+     mkdims(n, perm, vl, d);
+     X(cpynd)(I, O, 3, d, vl, nt);
+     bad = verify(I, O, d, vl);
+     if (bad)
+	  printf("cpynd of %dx%dx%d runs of %d into order %d%d%d%s: "
+		 "%d reals misplaced\n", n[0], n[1], n[2], (int) vl,
+		 perm[0], perm[1], perm[2], nt ? " (non-temporal)" : "", bad);
+     X(ifree)(O);
+     X(ifree)(I);
+     return bad != 0;
+}
+
+static int check_plan(const int *n, const int *perm, INT vl)
+{
+     INT N = n[0] * n[1] * n[2] * vl, i;
+     R *I = (R *) X(malloc)(sizeof(R) * N);
+     R *O = (R *) X(malloc)(sizeof(R) * N);
+     iodim d[3];
+     X(iodim) dims[4];
+     X(plan) p;
+     int k, bad;
+
+     mkdims(n, perm, vl, d);
+     for (k = 0; k < 3; ++k) {
+	  dims[k].n = (int) d[k].n;
+	  dims[k].is = (int) d[k].is;
+	  dims[k].os = (int) d[k].os;
+     }
+     dims[3].n = (int) vl;
+     dims[3].is = dims[3].os = 1;
+
+     p = X(plan_guru_r2r)(0, 0, 4, dims, I, O, 0, FFTW_ESTIMATE);
+     if (!p) {
+	  printf("cannot plan the transpose of %dx%dx%d runs of %d\n",
+		 n[0], n[1], n[2], (int) vl);
+	  X(free)(O);
+	  X(free)(I);
+	  return 1;
+     }
+
+     for (i = 0; i < N; ++i) {
+	  I[i] = (double) i;
+	  O[i] = -1.0;
+     }
+     X(execute)(p);
+     bad = verify(I, O, d, vl);
+     if (bad)
+	  printf("plan for %dx%dx%d runs of %d into order %d%d%d: "
+		 "%d reals misplaced\n", n[0], n[1], n[2], (int) vl,
+		 perm[0], perm[1], perm[2], bad);
+     X(destroy_plan)(p);
+     X(free)(O);
+     X(free)(I);
+     return bad != 0;
+}
+
+int main(void)
+{
+     static const INT vls[] = { 1, 2, 4 };
+     int s, k, v, fail = 0;
+
+     for (s = 0; s < NSIZES; ++s)
+	  for (k = 0; k < NPERMS; ++k)
+	       for (v = 0; v < 3; ++v) {
+		    fail += check_cpynd(sizes[s], perms[k], vls[v], 0);
+		    fail += check_cpynd(sizes[s], perms[k], vls[v], 1);
+		    fail += check_plan(sizes[s], perms[k], vls[v]);
+	       }
+     X(cleanup)();
+     return fail != 0;
+}
@@ -0,0 +1,138 @@
+/* Check plans made with FFTW_VARIABLE_HOWMANY: executed for every
+   number of vectors N from 0 to the number they were planned for
+   (which is not a power of two), complex, r2r and r2c plans must give
+   the same first N outputs as plans made for exactly N vectors, and
+   must not write the outputs of the vectors beyond N.  Out-of-range
+   counts must be refused. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fftw-bench.h"
+
+#define NMAX 13
+#define UNTOUCHED 12345.0
+
+enum { DFT, R2R, R2C };
+static const char *names[] = { "dft", "r2r", "r2c" };
+
+static double tol(void)
+{
+     return sizeof(bench_real) == sizeof(float) ? 1e-4 : 1e-10;
+}
+
+/* a plan for HOWMANY vectors of transforms of size N, from I to O */
+static FFTW(plan) mkmany(int kind, int n, int howmany, bench_real *I,
+			 bench_real *O, unsigned flags)
+{
+     FFTW(r2r_kind) k = FFTW_REDFT10;
+
+     switch (kind) {
+	 case DFT:
+	      return FFTW(plan_many_dft)(1, &n, howmany,
+					 (FFTW(complex) *) I, 0, 1, n,
+					 (FFTW(complex) *) O, 0, 1, n,
+					 FFTW_FORWARD, flags);
+	 case R2R:
+	      return FFTW(plan_many_r2r)(1, &n, howmany,
+					 I, 0, 1, n, O, 0, 1, n, &k, flags);
+	 default:
+	      return FFTW(plan_many_dft_r2c)(1, &n, howmany,
+					     I, 0, 1, n,
+					     (FFTW(complex) *) O, 0, 1,
+					     n / 2 + 1, flags);
+     }
+}
+
+static int check(int kind, int n)
+{
+     int ni = kind == DFT ? 2 * n : n;
+     int no = kind == DFT ? 2 * n : kind == R2R ? n : 2 * (n / 2 + 1);
+     bench_real *x, *I, *O, *Iref, *Oref;
+     FFTW(plan) p, ref;
+     int h, i, fail = 0;
+     double err;
+
+     x = (bench_real *) FFTW(malloc)(sizeof(bench_real) * ni * NMAX);
+     I = (bench_real *) FFTW(malloc)(sizeof(bench_real) * ni * NMAX);
+     O = (bench_real *) FFTW(malloc)(sizeof(bench_real) * no * NMAX);
+     Iref = (bench_real *) FFTW(malloc)(sizeof(bench_real) * ni * NMAX);
+     Oref = (bench_real *) FFTW(malloc)(sizeof(bench_real) * no * NMAX);
+
+     p = mkmany(kind, n, NMAX, I, O, FFTW_ESTIMATE | FFTW_VARIABLE_HOWMANY);
+     if (!p) {
+	  printf("cannot plan %s of size %d with FFTW_VARIABLE_HOWMANY\n",
+		 names[kind], n);
+	  fail = 1;
+	  goto done;
+     }
+     if (FFTW(plan_set_howmany)(p, -1)
+	 || FFTW(plan_set_howmany)(p, NMAX + 1)) {
+	  printf("%s of size %d: out-of-range count accepted\n",
+		 names[kind], n);
+	  fail = 1;
+     }
+
+     for (i = 0; i < ni * NMAX; ++i)
+	  x[i] = (rand() % 2001 - 1000) / 1000.0;
+
+     for (h = 0; h <= NMAX; ++h) {
+	  if (!FFTW(plan_set_howmany)(p, h)) {
+	       printf("%s of size %d: cannot set %d vectors\n",
+		      names[kind], n, h);
+	       fail = 1;
+	       continue;
+	  }
+	  for (i = 0; i < ni * NMAX; ++i)
+	       I[i] = x[i];
+	  for (i = 0; i < no * NMAX; ++i)
+	       O[i] = UNTOUCHED;
+	  FFTW(execute)(p);
+
+	  err = 0.0;
+	  if (h > 0) {
+	       ref = mkmany(kind, n, h, Iref, Oref, FFTW_ESTIMATE);
+	       for (i = 0; i < ni * h; ++i)
+		    Iref[i] = x[i];
+	       FFTW(execute)(ref);
+	       FFTW(destroy_plan)(ref);
+	       for (i = 0; i < no * h; ++i)
+		    err = fmax(err, fabs((double) (O[i] - Oref[i])));
+	  }
+	  if (err > tol() * n) {
+	       printf("%s of size %d for %d of %d vectors: error %g\n",
+		      names[kind], n, h, NMAX, err);
+	       fail = 1;
+	  }
+	  for (i = no * h; i < no * NMAX; ++i)
+	       if ((double) O[i] != UNTOUCHED) {
+		    printf("%s of size %d for %d of %d vectors: "
+			   "wrote vector %d\n", names[kind], n, h, NMAX,
+			   i / no);
+		    fail = 1;
+		    break;
+	       }
+     }
+
+ done:
+     FFTW(destroy_plan)(p);
+     FFTW(free)(Oref);
+     FFTW(free)(Iref);
+     FFTW(free)(O);
+     FFTW(free)(I);
+     FFTW(free)(x);
+     return fail;
+}
+
+int main(void)
+{
+     int fail = 0;
+
+     fail += check(DFT, 12);
+     fail += check(DFT, 7);
+     fail += check(R2R, 10);
+     fail += check(R2C, 16);
+     fail += check(R2C, 9);
+     FFTW(cleanup)();
+     return fail != 0;
+}
@@ -23,16 +23,42 @@
 
 static int threads_inited = 0;
 
+typedef struct {
+     void (*work)(void *data, int i);
+     void *data;
+} spawn_hook_data;
+
+static void *spawn_hook_apply(spawn_data *d)
+{
+     spawn_hook_data *h = (spawn_hook_data *) d->data;
+     h->work(h->data, d->min);
+     return 0;
+}
+
+static void spawn_hook(int nthr, void (*work)(void *data, int i), void *data)
+{
+     spawn_hook_data h;
+     h.work = work;
+     h.data = data;
+     X(spawn_loop)(nthr, nthr, spawn_hook_apply, (void *) &h);
+}
+
 static void threads_register_hooks(void)
 {
      X(mksolver_ct_hook) = X(mksolver_ct_threads);
      X(mksolver_hc2hc_hook) = X(mksolver_hc2hc_threads);
+     X(mksolver_hc2c_hook) = X(mksolver_hc2c_threads);
+     X(spawn_hook) = spawn_hook;
+     X(shmtab_lock_hook) = X(threads_lock_tables);
 }
 
 static void threads_unregister_hooks(void)
 {
      X(mksolver_ct_hook) = 0;
      X(mksolver_hc2hc_hook) = 0;
+     X(mksolver_hc2c_hook) = 0;
+     X(spawn_hook) = 0;
+     X(shmtab_lock_hook) = 0;
 }
 
 /* should be called before all other FFTW functions! */
@@ -79,3 +105,49 @@ void X(plan_with_nthreads)(int nthreads)
      plnr = X(the_planner)();
      plnr->nthr = X(imax)(1, nthreads);
 }
+
+void X(plan_with_thread_telemetry)(int enable)
+{
+     X(threads_telemetry) = enable;
+}
+
+spawn_loop_callback X(spawnloop_callback) = 0;
+void *X(spawnloop_callback_data) = 0;
+
+/* Run the parallel loops of all plans, including existing ones,
+   through PARALLEL_LOOP instead of FFTW's own threads: it must call
+   WORK(JOBDATA + i * ELSIZE) for 0 <= i < NJOBS, in any order and
+   possibly concurrently, and return when all calls have returned.
+   A null PARALLEL_LOOP restores the default. */
+void X(threads_set_callback)(
+     void (*parallel_loop)(void *(*work)(char *), char *jobdata,
+			   size_t elsize, int njobs, void *data),
+     void *data)
+{
+     X(spawnloop_callback) = parallel_loop;
+     X(spawnloop_callback_data) = data;
+}
+
+/* X(spawn_loop) with a user-supplied backend: one job per block */
+void X(spawn_loop_callback)(int loopmax, int nthr, int block_size,
+			    spawn_function proc, void *data)
+{
+     spawn_data *sdata;
+     int i;
+
+     THREAD_ON; /* prevent debugging mode from failing under threads */
+     STACK_MALLOC(spawn_data *, sdata, sizeof(spawn_data) * nthr);
+     for (i = 0; i < nthr; ++i) {
+	  spawn_data *d = &sdata[i];
+	  d->max = (d->min = i * block_size) + block_size;
+	  if (d->max > loopmax)
+	       d->max = loopmax;
+	  d->thr_num = i;
+	  d->data = data;
+     }
+     X(spawnloop_callback)((void *(*)(char *)) proc, (char *) sdata,
+			   sizeof(spawn_data), nthr,
+			   X(spawnloop_callback_data));
+     STACK_FREE(sdata);
+     THREAD_OFF; /* prevent debugging mode from failing under threads */
+}
@@ -26,6 +26,7 @@ typedef struct {
      plan *cld;
      plan **cldws;
      int nthr;
+     spawn_stats *stats;
      INT r;
 } P;
 
@@ -58,7 +59,8 @@ static void apply_dit(const plan *ego_, R *ri, R *ii, R *ro, R *io)
 	  d.r = ro; d.i = io;
 	  d.cldws = ego->cldws;
 
-	  X(spawn_loop)(ego->nthr, ego->nthr, spawn_apply, (void*)&d);
+	  X(spawn_loop_stats)(ego->nthr, ego->nthr, spawn_apply,
+			      (void*)&d, ego->stats);
      }
 }
 
@@ -73,7 +75,8 @@ static void apply_dif(const plan *ego_, R *ri, R *ii, R *ro, R *io)
 	  d.r = ri; d.i = ii;
 	  d.cldws = ego->cldws;
 
-	  X(spawn_loop)(ego->nthr, ego->nthr, spawn_apply, (void*)&d);
+	  X(spawn_loop_stats)(ego->nthr, ego->nthr, spawn_apply,
+			      (void*)&d, ego->stats);
      }
 
      cld = (plan_dft *) ego->cld;
@@ -97,6 +100,7 @@ static void destroy(plan *ego_)
      for (i = 0; i < ego->nthr; ++i)
 	  X(plan_destroy_internal)(ego->cldws[i]);
      X(ifree)(ego->cldws);
+     X(spawn_stats_destroy)(ego->stats);
 }
 
 static void print(const plan *ego_, printer *p)
@@ -110,7 +114,9 @@ static void print(const plan *ego_, printer *p)
           if (i == 0 || (ego->cldws[i] != ego->cldws[i-1] &&
                          (i <= 1 || ego->cldws[i] != ego->cldws[i-2])))
                p->print(p, "%(%p%)", ego->cldws[i]);
-     p->print(p, "%(%p%))", ego->cld);
+     p->print(p, "%(%p%)", ego->cld);
+     X(spawn_stats_print)(ego->stats, p);
+     p->putchr(p, ')');
 }
 
 static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
@@ -238,6 +244,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      pln->cld = cld;
      pln->cldws = cldws;
      pln->nthr = nthr;
+     pln->stats = X(mkspawn_stats)(nthr);
      pln->r = r;
      X(ops_zero)(&pln->super.super.ops);
      for (i = 0; i < nthr; ++i) {
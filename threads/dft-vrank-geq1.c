@@ -33,6 +33,7 @@ typedef struct {
      plan **cldrn;
      INT its, ots;
      int nthr;
+     spawn_stats *stats;
      const S *solver;
 } P;
 
@@ -66,7 +67,8 @@ static void apply(const plan *ego_, R *ri, R *ii, R *ro, R *io)
      d.cldrn = ego->cldrn;
      d.ri = ri; d.ii = ii; d.ro = ro; d.io = io;
 
-     X(spawn_loop)(ego->nthr, ego->nthr, spawn_apply, (void*) &d);
+     X(spawn_loop_stats)(ego->nthr, ego->nthr, spawn_apply, (void*) &d,
+			 ego->stats);
 }
 
 static void awake(plan *ego_, enum wakefulness wakefulness)
@@ -84,6 +86,7 @@ static void destroy(plan *ego_)
      for (i = 0; i < ego->nthr; ++i)
 	  X(plan_destroy_internal)(ego->cldrn[i]);
      X(ifree)(ego->cldrn);
+     X(spawn_stats_destroy)(ego->stats);
 }
 
 static void print(const plan *ego_, printer *p)
@@ -96,6 +99,7 @@ static void print(const plan *ego_, printer *p)
 	  if (i == 0 || (ego->cldrn[i] != ego->cldrn[i-1] &&
 			 (i <= 1 || ego->cldrn[i] != ego->cldrn[i-2])))
 	       p->print(p, "%(%p%)", ego->cldrn[i]);
+     X(spawn_stats_print)(ego->stats, p);
      p->putchr(p, ')');
 }
 
@@ -182,6 +186,7 @@ static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
      pln->its = its;
      pln->ots = ots;
      pln->nthr = nthr;
+     pln->stats = X(mkspawn_stats)(nthr);
 
      pln->solver = ego;
      X(ops_zero)(&pln->super.super.ops);
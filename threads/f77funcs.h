@@ -28,6 +28,11 @@ FFTW_VOIDFUNC F77(plan_with_nthreads, PLAN_WITH_NTHREADS)(int *nthreads)
      X(plan_with_nthreads)(*nthreads);
 }
 
+FFTW_VOIDFUNC F77(plan_with_thread_telemetry, PLAN_WITH_THREAD_TELEMETRY)(int *enable)
+{
+     X(plan_with_thread_telemetry)(*enable);
+}
+
 FFTW_VOIDFUNC F77(init_threads, INIT_THREADS)(int *okay)
 {
      *okay = X(init_threads)();
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* threaded version of rdft/ct-hc2c.c: the butterflies of the twiddle
+   pass are split among threads, one inferior plan per block */
+
+#include "threads.h"
+
+typedef struct {
+     plan_rdft2 super;
+     plan *cld;
+     plan **cldws;
+     int nthr;
+     spawn_stats *stats;
+     INT r;
+} P;
+
+typedef struct {
+     plan **cldws;
+     R *cr, *ci;
+} PD;
+
+static void *spawn_apply(spawn_data *d)
+{
+     PD *ego = (PD *) d->data;
+
+     plan_hc2c *cldw = (plan_hc2c *) (ego->cldws[d->thr_num]);
+     cldw->apply((plan *) cldw, ego->cr, ego->ci);
+     return 0;
+}
+
+static void apply_cldws(const P *ego, R *cr, R *ci)
+{
+     PD d;
+
+     d.cr = cr;
+     d.ci = ci;
+     d.cldws = ego->cldws;
+
+     X(spawn_loop_stats)(ego->nthr, ego->nthr, spawn_apply,
+			 (void*)&d, ego->stats);
+}
+
+static void apply_dit(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_rdft *cld;
+     UNUSED(r1);
+
+     cld = (plan_rdft *) ego->cld;
+     cld->apply(ego->cld, r0, cr);
+
+     apply_cldws(ego, cr, ci);
+}
+
+static void apply_dif(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_rdft *cld;
+     UNUSED(r1);
+
+     apply_cldws(ego, cr, ci);
+
+     cld = (plan_rdft *) ego->cld;
+     cld->apply(ego->cld, cr, r0);
+}
+
+static void apply_dit_dft(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_dft *cld;
+
+     cld = (plan_dft *) ego->cld;
+     cld->apply(ego->cld, r0, r1, cr, ci);
+
+     apply_cldws(ego, cr, ci);
+}
+
+static void apply_dif_dft(const plan *ego_, R *r0, R *r1, R *cr, R *ci)
+{
+     const P *ego = (const P *) ego_;
+     plan_dft *cld;
+
+     apply_cldws(ego, cr, ci);
+
+     cld = (plan_dft *) ego->cld;
+     cld->apply(ego->cld, ci, cr, r1, r0);
+}
+
+static void awake(plan *ego_, enum wakefulness wakefulness)
+{
+     P *ego = (P *) ego_;
+     int i;
+     X(plan_awake)(ego->cld, wakefulness);
+     for (i = 0; i < ego->nthr; ++i)
+	  X(plan_awake)(ego->cldws[i], wakefulness);
+}
+
+static void destroy(plan *ego_)
+{
+     P *ego = (P *) ego_;
+     int i;
+     X(plan_destroy_internal)(ego->cld);
+     for (i = 0; i < ego->nthr; ++i)
+	  X(plan_destroy_internal)(ego->cldws[i]);
+     X(ifree)(ego->cldws);
+     X(spawn_stats_destroy)(ego->stats);
+}
+
+static void print(const plan *ego_, printer *p)
+{
+     const P *ego = (const P *) ego_;
+     int i;
+     p->print(p, "(rdft2-thr-ct-%s-x%d/%D",
+	      (ego->super.apply == apply_dit || 
+	       ego->super.apply == apply_dit_dft)
+	      ? "dit" : "dif",
+	      ego->nthr, ego->r);
+     for (i = 0; i < ego->nthr; ++i)
+	  p->print(p, "%(%p%)", ego->cldws[i]);
+     p->print(p, "%(%p%)", ego->cld);
+     X(spawn_stats_print)(ego->stats, p);
+     p->putchr(p, ')');
+}
+
+/* Butterfly 0 goes with the first block.  The others are split in
+   blocks of a multiple of 4 butterflies, so that every block starts
+   at a properly aligned twiddle factor for SIMD codelets.  Return the
+   number of blocks, at most NTHR, for MCOUNT butterflies. */
+int X(hc2c_split)(INT mcount, int nthr, INT *block_size)
+{
+     INT bs = (mcount - 1 + nthr - 1) / nthr;
+     bs = ((bs + 3) / 4) * 4;
+     *block_size = bs;
+     return (int)((mcount - 1 + bs - 1) / bs);
+}
+
+/* the first butterfly of block I; block NBLOCKS starts at MCOUNT */
+INT X(hc2c_block_start)(INT mcount, int nblocks, INT block_size, int i)
+{
+     if (i == 0)
+	  return 0;
+     if (i == nblocks)
+	  return mcount;
+     return 1 + i * block_size;
+}
+
+static plan *mkplan(const solver *ego_, const problem *p_, planner *plnr)
+{
+     const hc2c_solver *ego = (const hc2c_solver *) ego_;
+     const problem_rdft2 *p;
+     P *pln = 0;
+     plan *cld = 0, **cldws = 0;
+     INT n, r, m, v, ivs, ovs, mcount, ms, vs;
+     int i, nthr, plnr_nthr_save;
+     INT block_size;
+     iodim *d;
+
+     static const plan_adt padt = {
+	  X(rdft2_solve), awake, print, destroy
+     };
+
+     if (plnr->nthr <= 1 || !X(hc2c_applicable)(ego, p_, plnr))
+          return (plan *) 0;
+
+     p = (const problem_rdft2 *) p_;
+     d = p->sz->dims;
+     n = d[0].n;
+     r = X(choose_radix)(ego->r, n);
+     A((r % 2) == 0);
+     m = n / r;
+     mcount = (m + 2) / 2;
+
+     X(tensor_tornk1)(p->vecsz, &v, &ivs, &ovs);
+
+     nthr = X(hc2c_split)(mcount, plnr->nthr, &block_size);
+     plnr_nthr_save = plnr->nthr;
+     plnr->nthr = (plnr->nthr + nthr - 1) / nthr;
+
+     /* the twiddle pass works in place on the complex output of an
+	R2HC problem, and on the complex input of an HC2R problem */
+     if (p->kind == R2HC) {
+	  ms = d[0].os; vs = ovs;
+     } else {
+	  ms = d[0].is; vs = ivs;
+     }
+
+     cldws = (plan **) MALLOC(sizeof(plan *) * nthr, PLANS);
+     for (i = 0; i < nthr; ++i) cldws[i] = (plan *) 0;
+
+     for (i = 0; i < nthr; ++i) {
+	  cldws[i] = ego->mkcldw(ego, p->kind,
+				 r, m * ms,
+				 m, ms,
+				 v, vs,
+				 X(hc2c_block_start)(mcount, nthr,
+						     block_size, i),
+				 X(hc2c_block_start)(mcount, nthr,
+						     block_size, i + 1),
+				 p->cr, p->ci, plnr);
+	  if (!cldws[i]) goto nada;
+     }
+
+     plnr->nthr = plnr_nthr_save;
+
+     switch (p->kind) {
+	 case R2HC:
+	      switch (ego->hc2ckind) {
+		  case HC2C_VIA_RDFT:
+		       cld = X(mkplan_d)(
+			    plnr, 
+			    X(mkproblem_rdft_1_d)(
+				 X(mktensor_1d)(m, (r/2)*d[0].is, d[0].os),
+				 X(mktensor_3d)(
+				      2, p->r1 - p->r0, p->ci - p->cr,
+				      r / 2, d[0].is, m * d[0].os,
+				      v, ivs, ovs),
+				 p->r0, p->cr, R2HC) 
+			    );
+		       if (!cld) goto nada;
+
+		       pln = MKPLAN_RDFT2(P, &padt, apply_dit);
+		       break;
+
+		  case HC2C_VIA_DFT:
+		       cld = X(mkplan_d)(
+			    plnr, 
+			    X(mkproblem_dft_d)(
+				 X(mktensor_1d)(m, (r/2)*d[0].is, d[0].os),
+				 X(mktensor_2d)(
+				      r / 2, d[0].is, m * d[0].os,
+				      v, ivs, ovs),
+				 p->r0, p->r1, p->cr, p->ci) 
+			    );
+		       if (!cld) goto nada;
+
+		       pln = MKPLAN_RDFT2(P, &padt, apply_dit_dft);
+		       break;
+	      }
+	      break;
+
+	 case HC2R:
+	      switch (ego->hc2ckind) {
+		  case HC2C_VIA_RDFT:
+		       cld = X(mkplan_d)(
+			    plnr, 
+			    X(mkproblem_rdft_1_d)(
+				 X(mktensor_1d)(m, d[0].is, (r/2)*d[0].os),
+				 X(mktensor_3d)(
+				      2, p->ci - p->cr, p->r1 - p->r0, 
+				      r / 2, m * d[0].is, d[0].os,
+				      v, ivs, ovs),
+				 p->cr, p->r0, HC2R) 
+			    );
+		       if (!cld) goto nada;
+
+		       pln = MKPLAN_RDFT2(P, &padt, apply_dif);
+		       break;
+
+		  case HC2C_VIA_DFT:
+		       cld = X(mkplan_d)(
+			    plnr, 
+			    X(mkproblem_dft_d)(
+				 X(mktensor_1d)(m, d[0].is, (r/2)*d[0].os),
+				 X(mktensor_2d)(
+				      r / 2, m * d[0].is, d[0].os,
+				      v, ivs, ovs),
+				 p->ci, p->cr, p->r1, p->r0) 
+			    );
+		       if (!cld) goto nada;
+
+		       pln = MKPLAN_RDFT2(P, &padt, apply_dif_dft);
+		       break;
+	      }
+	      break;
+
+	 default: 
+	      A(0);
+     }
+
+     pln->cld = cld;
+     pln->cldws = cldws;
+     pln->nthr = nthr;
+     pln->stats = X(mkspawn_stats)(nthr);
+     pln->r = r;
+     X(ops_zero)(&pln->super.super.ops);
+     for (i = 0; i < nthr; ++i) {
+          X(ops_add2)(&cldws[i]->ops, &pln->super.super.ops);
+	  pln->super.super.could_prune_now_p |= cldws[i]->could_prune_now_p;
+     }
+     X(ops_add2)(&cld->ops, &pln->super.super.ops);
+     return &(pln->super.super);
+
+ nada:
+     if (cldws) {
+	  for (i = 0; i < nthr; ++i)
+	       X(plan_destroy_internal)(cldws[i]);
+	  X(ifree)(cldws);
+     }
+     X(plan_destroy_internal)(cld);
+     return (plan *) 0;
+}
+
+hc2c_solver *X(mksolver_hc2c_threads)(size_t size, INT r, 
+				      hc2c_kind hc2ckind,
+				      hc2c_mkinferior mkcldw)
+{
+     static const solver_adt sadt = { PROBLEM_RDFT2, mkplan, 0 };
+     hc2c_solver *slv = (hc2c_solver *)X(mksolver)(size, &sadt);
+     slv->r = r;
+     slv->hc2ckind = hc2ckind;
+     slv->mkcldw = mkcldw;
+     return slv;
+}
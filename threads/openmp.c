@@ -21,13 +21,26 @@
 /* openmp.c: thread spawning via OpenMP  */
 
 #include "threads.h"
+#include <omp.h>
 
 #if !defined(_OPENMP)
 #error OpenMP enabled but not using an OpenMP compiler
 #endif
 
+/* guards the tables shared by all plans, see kernel/shmtab.c */
+static omp_lock_t tables_lock;
+
+void X(threads_lock_tables)(int lockp)
+{
+     if (lockp)
+	  omp_set_lock(&tables_lock);
+     else
+	  omp_unset_lock(&tables_lock);
+}
+
 int X(ithreads_init)(void)
 {
+     omp_init_lock(&tables_lock);
      return 0; /* no error */
 }
 
@@ -58,6 +71,11 @@ void X(spawn_loop)(int loopmax, int nthr, spawn_function proc, void *data)
      block_size = (loopmax + nthr - 1) / nthr;
      nthr = (loopmax + block_size - 1) / block_size;
 
+     if (X(spawnloop_callback)) {
+	  X(spawn_loop_callback)(loopmax, nthr, block_size, proc, data);
+	  return;
+     }
+
      THREAD_ON; /* prevent debugging mode from failing under threads */
 #pragma omp parallel for private(d)
      for (i = 0; i < nthr; ++i) {
@@ -73,4 +91,5 @@ void X(spawn_loop)(int loopmax, int nthr, spawn_function proc, void *data)
 
 void X(threads_cleanup)(void)
 {
+     omp_destroy_lock(&tables_lock);
 }
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2003, 2007-11 Matteo Frigo
+ * Copyright (c) 2003, 2007-11 Massachusetts Institute of Technology
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/* telemetry.c: optional load-balance statistics for X(spawn_loop).
+
+   A threaded plan created while telemetry is enabled owns a
+   spawn_stats, and runs its loop through X(spawn_loop_stats).  For
+   each block of the loop we time, with the cycle counter, the delay
+   between the call and the start of the block (dispatch), the block
+   itself (busy, accumulated per thread), and the delay between the
+   end of the block and the return of the call (wait at the join).
+   The totals are printed with the plan.
+
+   Updates are not atomic: the numbers are only meaningful if the
+   plan is not executed by several threads at the same time. */
+
+#include "threads.h"
+
+#ifndef WITH_SLOW_TIMER
+#  include "cycle.h"
+#endif
+
+int X(threads_telemetry) = 0;
+
+#ifdef HAVE_TICK_COUNTER
+
+spawn_stats *X(mkspawn_stats)(int nthr)
+{
+     spawn_stats *st;
+     int i;
+
+     if (!X(threads_telemetry))
+	  return 0;
+
+     st = (spawn_stats *) MALLOC(sizeof(spawn_stats), PLANS);
+     st->nthr = nthr;
+     st->ncalls = 0;
+     st->dispatch = st->wait = 0.0;
+     st->busy = (double *) MALLOC(sizeof(double) * nthr, PLANS);
+     for (i = 0; i < nthr; ++i)
+	  st->busy[i] = 0.0;
+     return st;
+}
+
+typedef struct {
+     spawn_function proc;
+     void *data;
+     ticks *start, *end;
+} timed_data;
+
+static void *timed_proc(spawn_data *d)
+{
+     timed_data *td = (timed_data *) d->data;
+     spawn_data d1 = *d;
+
+     d1.data = td->data;
+     td->start[d->thr_num] = getticks();
+     td->proc(&d1);
+     td->end[d->thr_num] = getticks();
+     return 0;
+}
+
+void X(spawn_loop_stats)(int loopmax, int nthr, spawn_function proc,
+			 void *data, spawn_stats *st)
+{
+     timed_data td;
+     ticks t0, t1;
+     int i, block_size;
+
+     if (!st || !loopmax) {
+	  X(spawn_loop)(loopmax, nthr, proc, data);
+	  return;
+     }
+
+     /* the same blocking as X(spawn_loop) */
+     block_size = (loopmax + nthr - 1) / nthr;
+     nthr = (loopmax + block_size - 1) / block_size;
+     A(nthr <= st->nthr);
+
+     td.proc = proc;
+     td.data = data;
+     STACK_MALLOC(ticks *, td.start, sizeof(ticks) * 2 * nthr);
+     td.end = td.start + nthr;
+
+     t0 = getticks();
+     X(spawn_loop)(loopmax, nthr, timed_proc, (void *) &td);
+     t1 = getticks();
+
+     for (i = 0; i < nthr; ++i) {
+	  st->dispatch += elapsed(td.start[i], t0);
+	  st->busy[i] += elapsed(td.end[i], td.start[i]);
+	  st->wait += elapsed(t1, td.end[i]);
+     }
+     ++st->ncalls;
+
+     STACK_FREE(td.start);
+}
+
+#else /* no cycle counter: telemetry is not available */
+
+spawn_stats *X(mkspawn_stats)(int nthr)
+{
+     UNUSED(nthr);
+     return 0;
+}
+
+void X(spawn_loop_stats)(int loopmax, int nthr, spawn_function proc,
+			 void *data, spawn_stats *st)
+{
+     UNUSED(st);
+     X(spawn_loop)(loopmax, nthr, proc, data);
+}
+
+#endif
+
+void X(spawn_stats_destroy)(spawn_stats *st)
+{
+     if (st) {
+	  X(ifree)(st->busy);
+	  X(ifree)(st);
+     }
+}
+
+/* Averages per call, in cycle-counter ticks.  The imbalance is the
+   busiest thread over the mean, in percent (100 = perfect balance,
+   0 = no busy time measured). */
+void X(spawn_stats_print)(const spawn_stats *st, printer *p)
+{
+     double busymax = 0.0, busysum = 0.0;
+     INT n;
+     int i;
+
+     if (!st || !st->ncalls)
+	  return;
+
+     n = st->ncalls;
+     for (i = 0; i < st->nthr; ++i) {
+	  busysum += st->busy[i];
+	  if (st->busy[i] > busymax)
+	       busymax = st->busy[i];
+     }
+
+     p->print(p, "%((telemetry-calls=%D-dispatch=%D-wait=%D-busy",
+	      n, (INT) (st->dispatch / n), (INT) (st->wait / n));
+     for (i = 0; i < st->nthr; ++i)
+	  p->print(p, "%c%D", i ? ',' : '=', (INT) (st->busy[i] / n));
+     if (busysum > 0)
+	  busymax *= 100.0 * st->nthr / busysum;
+     p->print(p, "-imbalance=%D)%)", (INT) busymax);
+}
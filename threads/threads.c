@@ -354,9 +354,21 @@ static void kill_workforce(void)
      THREAD_OFF;
 }
 
+/* guards the tables shared by all plans, see kernel/shmtab.c */
+static os_mutex_t tables_lock;
+
+void X(threads_lock_tables)(int lockp)
+{
+     if (lockp)
+	  os_mutex_lock(&tables_lock);
+     else
+	  os_mutex_unlock(&tables_lock);
+}
+
 int X(ithreads_init)(void)
 {
      os_mutex_init(&queue_lock);
+     os_mutex_init(&tables_lock);
      os_sem_init(&termination_semaphore);
 
      WITH_QUEUE_LOCK({
@@ -393,6 +405,11 @@ void X(spawn_loop)(int loopmax, int nthr, spawn_function proc, void *data)
      block_size = (loopmax + nthr - 1) / nthr;
      nthr = (loopmax + block_size - 1) / block_size;
 
+     if (X(spawnloop_callback)) {
+	  X(spawn_loop_callback)(loopmax, nthr, block_size, proc, data);
+	  return;
+     }
+
      THREAD_ON; /* prevent debugging mode from failing under threads */
      STACK_MALLOC(struct work *, r, sizeof(struct work) * nthr);
 	  
@@ -435,5 +452,6 @@ void X(threads_cleanup)(void)
 {
      kill_workforce();
      os_mutex_destroy(&queue_lock);
+     os_mutex_destroy(&tables_lock);
      os_sem_destroy(&termination_semaphore);
 }
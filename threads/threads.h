@@ -24,6 +24,7 @@
 #include "ifftw.h"
 #include "ct.h"
 #include "hc2hc.h"
+#include "ct-hc2c.h"
 
 typedef struct {
      int min, max, thr_num;
@@ -36,6 +37,30 @@ void X(spawn_loop)(int loopmax, int nthreads,
 		   spawn_function proc, void *data);
 int X(ithreads_init)(void);
 void X(threads_cleanup)(void);
+void X(threads_lock_tables)(int lockp);
+
+/* user-supplied backend for X(spawn_loop), see X(threads_set_callback) */
+typedef void (*spawn_loop_callback)(void *(*work)(char *), char *jobdata,
+				    size_t elsize, int njobs, void *data);
+extern spawn_loop_callback X(spawnloop_callback);
+extern void *X(spawnloop_callback_data);
+void X(spawn_loop_callback)(int loopmax, int nthr, int block_size,
+			    spawn_function proc, void *data);
+
+/* load-balance telemetry, see telemetry.c */
+typedef struct {
+     int nthr;
+     INT ncalls;
+     double dispatch, wait;  /* summed over calls and blocks */
+     double *busy;           /* per thread, summed over calls */
+} spawn_stats;
+
+extern int X(threads_telemetry);
+spawn_stats *X(mkspawn_stats)(int nthr);
+void X(spawn_stats_destroy)(spawn_stats *st);
+void X(spawn_loop_stats)(int loopmax, int nthreads,
+			 spawn_function proc, void *data, spawn_stats *st);
+void X(spawn_stats_print)(const spawn_stats *st, printer *p);
 
 /* configurations */
 
@@ -47,6 +72,10 @@ ct_solver *X(mksolver_ct_threads)(size_t size, INT r, int dec,
 				  ct_mkinferior mkcldw,
 				  ct_force_vrecursion force_vrecursionp);
 hc2hc_solver *X(mksolver_hc2hc_threads)(size_t size, INT r, hc2hc_mkinferior mkcldw);
+hc2c_solver *X(mksolver_hc2c_threads)(size_t size, INT r, hc2c_kind hc2ckind,
+				      hc2c_mkinferior mkcldw);
+int X(hc2c_split)(INT mcount, int nthr, INT *block_size);
+INT X(hc2c_block_start)(INT mcount, int nblocks, INT block_size, int i);
 
 void X(threads_conf_standard)(planner *p);
 void X(threads_register_hooks)(void);
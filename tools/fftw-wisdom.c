@@ -6,6 +6,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#ifdef BENCHFFT_DDOUBLE
+#  define FFTW_DD /* declare the fftwdd_ API */
+#endif
 #include <fftw3.h>
 #include <string.h>
 #include <time.h>
@@ -22,6 +25,8 @@
 #define FFTW(x) CONCAT(fftwl_, x)
 #elif defined(BENCHFFT_QUAD)
 #define FFTW(x) CONCAT(fftwq_, x)
+#elif defined(BENCHFFT_DDOUBLE)
+#define FFTW(x) CONCAT(fftwdd_, x)
 #else
 #define FFTW(x) CONCAT(fftw_, x)
 #endif